@@ -14,7 +14,6 @@ using namespace placo::model;
 
 // Overloads
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(set_passive_overloads, set_passive, 1, 3);
-BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(solve_overloads, solve, 0, 1);
 
 void exposeDynamics()
 {
@@ -24,6 +23,12 @@ void exposeDynamics()
           "tau", +[](const DynamicsSolver::Result& result) { return result.tau; })
       .add_property(
           "qdd", +[](const DynamicsSolver::Result& result) { return result.qdd; })
+      .add_property(
+          "tau_view",
+          numpy_view(+[](DynamicsSolver::Result& result) -> Eigen::Ref<Eigen::VectorXd> { return result.tau; }))
+      .add_property(
+          "qdd_view",
+          numpy_view(+[](DynamicsSolver::Result& result) -> Eigen::Ref<Eigen::VectorXd> { return result.qdd; }))
       .def(
           "tau_dict", +[](const DynamicsSolver::Result& result, RobotWrapper& robot) {
             boost::python::dict dict;
@@ -104,7 +109,16 @@ void exposeDynamics()
       .def("enable_joint_limits", &DynamicsSolver::enable_joint_limits)
       .def("enable_torque_limits", &DynamicsSolver::enable_torque_limits)
       .def("dump_status", &DynamicsSolver::dump_status)
-      .def("solve", &DynamicsSolver::solve, solve_overloads())
+      .def(
+          "solve", +[](DynamicsSolver& solver) {
+            ScopedGILRelease release;
+            return solver.solve();
+          })
+      .def(
+          "solve", +[](DynamicsSolver& solver, bool integrate) {
+            ScopedGILRelease release;
+            return solver.solve(integrate);
+          })
       .def<void (DynamicsSolver::*)(Task&)>("add_task", &DynamicsSolver::add_task)
       .def<void (DynamicsSolver::*)(Constraint&)>("add_constraint", &DynamicsSolver::add_constraint)
       .def<void (DynamicsSolver::*)(Constraint&)>("add_constraint", &DynamicsSolver::add_constraint)
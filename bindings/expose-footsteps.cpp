@@ -6,6 +6,7 @@
 #include "placo/humanoid/footsteps_planner.h"
 #include "placo/humanoid/footsteps_planner_naive.h"
 #include "placo/humanoid/footsteps_planner_repetitive.h"
+#include "placo/humanoid/footsteps_planner_search.h"
 #include <Eigen/Dense>
 #include <boost/python.hpp>
 
@@ -50,8 +51,12 @@ void exposeFootsteps()
 
   class__<FootstepsPlanner, boost::noncopyable>("FootstepsPlanner", no_init)
       .def("make_supports", &FootstepsPlanner::make_supports)
+      .def("reuse_polygons", &FootstepsPlanner::reuse_polygons)
+      .staticmethod("reuse_polygons")
       .def("add_first_support", &FootstepsPlanner::add_first_support)
-      .def("opposite_footstep", &FootstepsPlanner::opposite_footstep);
+      .def("opposite_footstep", &FootstepsPlanner::opposite_footstep)
+      .add_property("incremental", &FootstepsPlanner::incremental, &FootstepsPlanner::incremental)
+      .add_property("committed_steps", &FootstepsPlanner::committed_steps, &FootstepsPlanner::committed_steps);
 
   class__<FootstepsPlannerNaive, bases<FootstepsPlanner>>("FootstepsPlannerNaive", init<HumanoidParameters&>())
       .def("plan", &FootstepsPlannerNaive::plan)
@@ -62,6 +67,39 @@ void exposeFootsteps()
       .def("plan", &FootstepsPlannerRepetitive::plan)
       .def("configure", &FootstepsPlannerRepetitive::configure);
 
+  class__<FootstepsPlannerSearch, bases<FootstepsPlanner>>("FootstepsPlannerSearch", init<HumanoidParameters&>())
+      .def("plan", &FootstepsPlannerSearch::plan)
+      .def("configure", &FootstepsPlannerSearch::configure)
+      .def("set_cost_map", &FootstepsPlannerSearch::set_cost_map)
+      .def("clear_cost_map", &FootstepsPlannerSearch::clear_cost_map)
+      .def("map_cost", &FootstepsPlannerSearch::map_cost)
+      .add_property("actions_x", &FootstepsPlannerSearch::actions_x, &FootstepsPlannerSearch::actions_x)
+      .add_property("actions_y", &FootstepsPlannerSearch::actions_y, &FootstepsPlannerSearch::actions_y)
+      .add_property("actions_yaw", &FootstepsPlannerSearch::actions_yaw, &FootstepsPlannerSearch::actions_yaw)
+      .add_property("step_cost", &FootstepsPlannerSearch::step_cost, &FootstepsPlannerSearch::step_cost)
+      .add_property("cost_weight", &FootstepsPlannerSearch::cost_weight, &FootstepsPlannerSearch::cost_weight)
+      .add_property("obstacle_threshold", &FootstepsPlannerSearch::obstacle_threshold,
+                    &FootstepsPlannerSearch::obstacle_threshold)
+      .add_property("outside_cost", &FootstepsPlannerSearch::outside_cost, &FootstepsPlannerSearch::outside_cost)
+      .add_property("goal_tolerance", &FootstepsPlannerSearch::goal_tolerance,
+                    &FootstepsPlannerSearch::goal_tolerance)
+      .add_property("goal_yaw_tolerance", &FootstepsPlannerSearch::goal_yaw_tolerance,
+                    &FootstepsPlannerSearch::goal_yaw_tolerance)
+      .add_property("discretization_xy", &FootstepsPlannerSearch::discretization_xy,
+                    &FootstepsPlannerSearch::discretization_xy)
+      .add_property("discretization_yaw", &FootstepsPlannerSearch::discretization_yaw,
+                    &FootstepsPlannerSearch::discretization_yaw)
+      .add_property("initial_epsilon", &FootstepsPlannerSearch::initial_epsilon,
+                    &FootstepsPlannerSearch::initial_epsilon)
+      .add_property("epsilon_decrease", &FootstepsPlannerSearch::epsilon_decrease,
+                    &FootstepsPlannerSearch::epsilon_decrease)
+      .add_property("max_time", &FootstepsPlannerSearch::max_time, &FootstepsPlannerSearch::max_time)
+      .add_property("max_expansions", &FootstepsPlannerSearch::max_expansions,
+                    &FootstepsPlannerSearch::max_expansions)
+      .add_property("max_steps", &FootstepsPlannerSearch::max_steps, &FootstepsPlannerSearch::max_steps)
+      .add_property("expansions", &FootstepsPlannerSearch::expansions)
+      .add_property("solution_epsilon", &FootstepsPlannerSearch::solution_epsilon);
+
   // Exposing vector of footsteps
   exposeStdVector<FootstepsPlanner::Footstep>("Footsteps");
   exposeStdVector<FootstepsPlanner::Support>("Supports");
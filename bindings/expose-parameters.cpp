@@ -16,6 +16,10 @@ using namespace placo::humanoid;
 
 void exposeParameters()
 {
+  enum_<HumanoidParameters::CoMPlanner>("CoMPlanner")
+      .value("jerk_planner", HumanoidParameters::CoMPlanner::JerkPlanner)
+      .value("dcm_planner", HumanoidParameters::CoMPlanner::DCMPlanner);
+
   class__<HumanoidParameters>("HumanoidParameters")
       .add_property("single_support_duration", &HumanoidParameters::single_support_duration,
                     &HumanoidParameters::single_support_duration)
@@ -28,6 +32,7 @@ void exposeParameters()
       .add_property("kick_support_ratio", &HumanoidParameters::kick_support_ratio,
                     &HumanoidParameters::kick_support_ratio)
       .add_property("planned_timesteps", &HumanoidParameters::planned_timesteps, &HumanoidParameters::planned_timesteps)
+      .add_property("com_planner", &HumanoidParameters::com_planner, &HumanoidParameters::com_planner)
       .add_property("replan_timesteps", &HumanoidParameters::replan_timesteps, &HumanoidParameters::replan_timesteps)
       .add_property("zmp_margin", &HumanoidParameters::zmp_margin, &HumanoidParameters::zmp_margin)
       .add_property("walk_foot_height", &HumanoidParameters::walk_foot_height, &HumanoidParameters::walk_foot_height)
@@ -70,15 +70,34 @@ void exposeProblem()
           })
       .add_property("weight", &ProblemConstraint::weight)
       .add_property("is_active", &ProblemConstraint::is_active)
+      .add_property("active_rows", &ProblemConstraint::active_rows, &ProblemConstraint::active_rows)
       .def<void (ProblemConstraint::*)(std::string, double)>("configure", &ProblemConstraint::configure,
                                                              configure_overloads());
 
   class__<PolygonConstraint>("PolygonConstraint")
       .def("in_polygon", &PolygonConstraint::in_polygon)
       .staticmethod("in_polygon")
-      .def("in_polygon_xy", &PolygonConstraint::in_polygon_xy)
+      .def<ProblemConstraint (*)(const Expression&, std::vector<Eigen::Vector2d>, double)>(
+          "in_polygon_xy", &PolygonConstraint::in_polygon_xy)
       .staticmethod("in_polygon_xy");
 
+  class__<PolygonConstraint::HalfPlanes>("HalfPlanes", init<std::vector<Eigen::Vector2d>, optional<double>>())
+      .add_property(
+          "normals", +[](const PolygonConstraint::HalfPlanes& half_planes) { return half_planes.normals; })
+      .add_property(
+          "offsets", +[](const PolygonConstraint::HalfPlanes& half_planes) { return half_planes.offsets; })
+      .def<ProblemConstraint (PolygonConstraint::HalfPlanes::*)(const Expression&) const>(
+          "apply", &PolygonConstraint::HalfPlanes::apply)
+      .def(
+          "apply_all", +[](const PolygonConstraint::HalfPlanes& half_planes, boost::python::list expressions) {
+            std::vector<Expression> expressions_xy;
+            for (int k = 0; k < len(expressions); k++)
+            {
+              expressions_xy.push_back(extract<Expression>(expressions[k]));
+            }
+            return half_planes.apply(expressions_xy);
+          });
+
   class__<Integrator>("Integrator", init<Variable&, Expression, int, double>())
       .def(init<Variable&, Eigen::VectorXd, Eigen::MatrixXd, double>())
       .def("upper_shift_matrix", &Integrator::upper_shift_matrix)
@@ -99,6 +118,7 @@ void exposeProblem()
 
   class__<Integrator::Trajectory>("IntegratorTrajectory")
       .def("value", &Integrator::Trajectory::value)
+      .def("values", &Integrator::Trajectory::values)
       .def("duration", &Integrator::Trajectory::duration);
 
   class__<Problem>("Problem")
@@ -117,6 +137,8 @@ void exposeProblem()
       .add_property("slack_variables", &Problem::slack_variables, &Problem::slack_variables)
       .add_property("use_sparsity", &Problem::use_sparsity, &Problem::use_sparsity)
       .add_property("rewrite_equalities", &Problem::rewrite_equalities, &Problem::rewrite_equalities)
+      .add_property("warm_start", &Problem::warm_start, &Problem::warm_start)
+      .add_property("warm_started", &Problem::warm_started)
       .add_property(
           "slacks", +[](const Problem& problem) { return problem.slacks; });
 
@@ -8,6 +8,7 @@
 #include "placo/kinematics/kinematics_solver.h"
 #include <Eigen/Dense>
 #include <boost/python.hpp>
+#include <boost/python/return_internal_reference.hpp>
 
 using namespace boost::python;
 using namespace placo;
@@ -19,15 +20,19 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(read_from_histories_overloads, read_from_
 #endif
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(joint_names_overloads, joint_names, 0, 1);
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(prune_collision_pairs_overloads, prune_collision_pairs, 0, 3);
 
 template <class RobotType, class W1>
 void exposeRobotType(class_<RobotType, W1>& type)
 {
   type.add_property("state", &RobotType::state)
-      .add_property("model", &RobotType::model)
+      .add_property("model", make_function(
+                                 +[](RobotType& robot) -> pinocchio::Model& { return robot.model; },
+                                 return_internal_reference<>()))
       .add_property("collision_model", &RobotType::collision_model)
-      .add_property("visual_model", &RobotType::visual_model)
+      .add_property("visual_model", make_function(&RobotType::get_visual_model, return_internal_reference<>()))
       .def("load_collision_pairs", &RobotType::load_collision_pairs)
+      .def("prune_collision_pairs", &RobotType::prune_collision_pairs, prune_collision_pairs_overloads())
       .def("get_joint_offset", &RobotType::get_joint_offset)
       .def("get_joint_v_offset", &RobotType::get_joint_v_offset)
       .def("reset", &RobotType::reset)
@@ -38,18 +43,42 @@ void exposeRobotType(class_<RobotType, W1>& type)
       .def("get_joint_velocity", &RobotType::get_joint_velocity)
       .def("set_joint_acceleration", &RobotType::set_joint_acceleration)
       .def("get_joint_acceleration", &RobotType::get_joint_acceleration)
+      .def("joint_selection", &RobotType::joint_selection)
+      .def("set_joints", &RobotType::set_joints)
+      .def("get_joints", &RobotType::get_joints)
+      .def("set_joint_velocities", &RobotType::set_joint_velocities)
+      .def("get_joint_velocities", &RobotType::get_joint_velocities)
       .def("set_velocity_limit", &RobotType::set_velocity_limit)
       .def("set_velocity_limits", &RobotType::set_velocity_limits)
       .def("set_torque_limit", &RobotType::set_torque_limit)
       .def("set_joint_limits", &RobotType::set_joint_limits)
-      .def("update_kinematics", &RobotType::update_kinematics)
+      .def(
+          "update_kinematics", +[](RobotType& robot) {
+            ScopedGILRelease release;
+            robot.update_kinematics();
+          })
       .def("get_T_world_fbase", &RobotType::get_T_world_fbase)
       .def("set_T_world_fbase", &RobotType::set_T_world_fbase)
       .def("com_world", &RobotType::com_world)
       .def("joint_names", &RobotType::joint_names, joint_names_overloads())
       .def("frame_names", &RobotType::frame_names)
-      .def("self_collisions", &RobotType::self_collisions)
-      .def("distances", &RobotType::distances)
+      .def(
+          "self_collisions", +[](RobotType& robot, bool stop_at_first) {
+            ScopedGILRelease release;
+            return robot.self_collisions(stop_at_first);
+          })
+      .def(
+          "distances", +[](RobotType& robot) {
+            ScopedGILRelease release;
+            return robot.distances();
+          })
+      .def(
+          "distances", +[](RobotType& robot, double max_distance) {
+            ScopedGILRelease release;
+            std::vector<RobotWrapper::Distance> distances;
+            robot.distances(distances, max_distance);
+            return distances;
+          })
       .def("com_jacobian", &RobotType::com_jacobian)
       .def("com_jacobian_time_variation", &RobotType::com_jacobian_time_variation)
       .def("generalized_gravity", &RobotType::generalized_gravity)
@@ -125,8 +154,13 @@ void exposeRobotWrapper()
 {
   enum_<RobotWrapper::Flags>("Flags")
       .value("collision_as_visual", RobotWrapper::Flags::COLLISION_AS_VISUAL)
-      .value("ignore_collisions", RobotWrapper::Flags::IGNORE_COLLISIONS);
+      .value("ignore_collisions", RobotWrapper::Flags::IGNORE_COLLISIONS)
+      .value("convex_collisions", RobotWrapper::Flags::CONVEX_COLLISIONS)
+      .value("model_cache", RobotWrapper::Flags::MODEL_CACHE)
+      .value("lazy_visual", RobotWrapper::Flags::LAZY_VISUAL);
 
+  // State vectors are returned as copies, the *_view properties are numpy arrays sharing their memory (see
+  // numpy_view)
   class__<RobotWrapper::State>("RobotWrapper_State")
       .add_property(
           "q", +[](const RobotWrapper::State& state) { return state.q; },
@@ -136,9 +170,19 @@ void exposeRobotWrapper()
           +[](RobotWrapper::State& state, const Eigen::VectorXd& qd) { state.qd = qd; })
       .add_property(
           "qdd", +[](const RobotWrapper::State& state) { return state.qdd; },
-          +[](RobotWrapper::State& state, const Eigen::VectorXd& qdd) { state.qdd = qdd; });
+          +[](RobotWrapper::State& state, const Eigen::VectorXd& qdd) { state.qdd = qdd; })
+      .add_property("q_view",
+                    numpy_view(+[](RobotWrapper::State& state) -> Eigen::Ref<Eigen::VectorXd> { return state.q; }))
+      .add_property("qd_view",
+                    numpy_view(+[](RobotWrapper::State& state) -> Eigen::Ref<Eigen::VectorXd> { return state.qd; }))
+      .add_property("qdd_view",
+                    numpy_view(+[](RobotWrapper::State& state) -> Eigen::Ref<Eigen::VectorXd> { return state.qdd; }));
   ;
 
+  class__<RobotWrapper::JointSelection>("JointSelection")
+      .add_property(
+          "names", +[](const RobotWrapper::JointSelection& selection) { return selection.names; });
+
   class__<RobotWrapper::Collision>("Collision")
       .add_property("objA", &RobotWrapper::Collision::objA)
       .add_property("objB", &RobotWrapper::Collision::objB)
@@ -161,11 +205,13 @@ void exposeRobotWrapper()
       .add_property("min_distance", &RobotWrapper::Distance::min_distance);
 
   class_<RobotWrapper> robotWrapper =
-      class__<RobotWrapper>("RobotWrapper", init<std::string, optional<int, std::string>>());
+      class__<RobotWrapper>("RobotWrapper", init<std::string, optional<int, std::string>>())
+          .def(init<const RobotWrapper&>());
   exposeRobotType<RobotWrapper>(robotWrapper);
 
   class_<HumanoidRobot, bases<RobotWrapper>> humanoidWrapper =
-      class__<HumanoidRobot, bases<RobotWrapper>>("HumanoidRobot", init<std::string, optional<int, std::string>>());
+      class__<HumanoidRobot, bases<RobotWrapper>>("HumanoidRobot", init<std::string, optional<int, std::string>>())
+          .def(init<const HumanoidRobot&>());
 
   exposeRobotType<HumanoidRobot>(humanoidWrapper);
   humanoidWrapper
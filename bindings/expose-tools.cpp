@@ -9,6 +9,7 @@
 #include "placo/tools/cubic_spline_3d.h"
 #include "placo/tools/axises_mask.h"
 #include "placo/tools/prioritized.h"
+#include "placo/tools/polygon_2d.h"
 #include "expose-utils.hpp"
 #ifdef HAVE_RHOBAN_UTILS
 #include "rhoban_utils/history/history.h"
@@ -23,6 +24,7 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(loadReplays_overloads, loadReplays, 1, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(set_axises_overloads, set_axises, 1, 2);
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(configure_overloads, configure, 2, 3);
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(contains_overloads, contains, 1, 2);
 
 void exposeTools()
 {
@@ -59,18 +61,35 @@ void exposeTools()
       .def<void (Prioritized::*)(std::string, std::string, double)>("configure", &Prioritized::configure,
                                                                     configure_overloads());
 
+  class__<Polygon2d>("Polygon2d", init<>())
+      .def(init<std::vector<Eigen::Vector2d>>())
+      .def("size", &Polygon2d::size)
+      .def("clear", &Polygon2d::clear)
+      .def("push_back", &Polygon2d::push_back)
+      .def("point", &Polygon2d::point)
+      .def("to_vector", &Polygon2d::to_vector)
+      .def("convex_hull", &Polygon2d::convex_hull)
+      .def("contains", &Polygon2d::contains, contains_overloads())
+      .def("overlap", &Polygon2d::overlap);
+
   class__<CubicSpline>("CubicSpline", init<optional<bool>>())
-      .def("pos", &CubicSpline::pos)
-      .def("vel", &CubicSpline::vel)
+      .def<double (CubicSpline::*)(double)>("pos", &CubicSpline::pos)
+      .def<double (CubicSpline::*)(double)>("vel", &CubicSpline::vel)
+      .def<Eigen::VectorXd (CubicSpline::*)(const Eigen::VectorXd&)>("pos", &CubicSpline::pos)
+      .def<Eigen::VectorXd (CubicSpline::*)(const Eigen::VectorXd&)>("vel", &CubicSpline::vel)
       .def("add_point", &CubicSpline::add_point)
       .def("clear", &CubicSpline::clear)
+      .def("update", &CubicSpline::update)
       .def("duration", &CubicSpline::duration);
 
   class__<CubicSpline3D>("CubicSpline3D")
-      .def("pos", &CubicSpline3D::pos)
-      .def("vel", &CubicSpline3D::vel)
+      .def<Eigen::Vector3d (CubicSpline3D::*)(double)>("pos", &CubicSpline3D::pos)
+      .def<Eigen::Vector3d (CubicSpline3D::*)(double)>("vel", &CubicSpline3D::vel)
+      .def<Eigen::MatrixXd (CubicSpline3D::*)(const Eigen::VectorXd&)>("pos", &CubicSpline3D::pos)
+      .def<Eigen::MatrixXd (CubicSpline3D::*)(const Eigen::VectorXd&)>("vel", &CubicSpline3D::vel)
       .def("add_point", &CubicSpline3D::add_point)
       .def("clear", &CubicSpline3D::clear)
+      .def("update", &CubicSpline3D::update)
       .def("duration", &CubicSpline3D::duration);
 
 #ifdef HAVE_RHOBAN_UTILS
@@ -55,6 +55,40 @@ void exposeStdVector(const std::string& class_name)
   custom_vector_from_seq<T>();
 }
 
+/**
+ * @brief Releases the Python GIL during its lifetime, so that other Python threads can run while a long C++
+ * computation is in progress. No Python object should be accessed while it is alive.
+ */
+class ScopedGILRelease
+{
+public:
+  ScopedGILRelease()
+  {
+    state = PyEval_SaveThread();
+  }
+
+  ~ScopedGILRelease()
+  {
+    PyEval_RestoreThread(state);
+  }
+
+protected:
+  PyThreadState* state;
+};
+
+/**
+ * @brief Wraps a getter returning an Eigen::Ref so that it is exposed as a numpy array sharing the memory of the
+ * underlying Eigen object (no copy, and writing to the array writes to the object). The owner is kept alive as
+ * long as the array exists. The array becomes invalid if the Eigen object is resized on the C++ side, it should
+ * only be used for objects whose size doesn't change.
+ * @param getter getter function
+ */
+template <typename Owner, typename RefType>
+object numpy_view(RefType (*getter)(Owner&))
+{
+  return make_function(getter, with_custodian_and_ward_postcall<0, 1>());
+}
+
 template <typename K, typename V>
 void exposeStdMap(const std::string& class_name)
 {
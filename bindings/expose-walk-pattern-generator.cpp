@@ -41,33 +41,125 @@ void exposeWalkPatternGenerator()
       .def("get_next_support", &WalkPatternGenerator::Trajectory::get_next_support)
       .def("get_prev_support", &WalkPatternGenerator::Trajectory::get_prev_support)
       .def("get_part_t_start", &WalkPatternGenerator::Trajectory::get_part_t_start)
-      .def("apply_transform", &WalkPatternGenerator::Trajectory::apply_transform);
+      .def("apply_transform", &WalkPatternGenerator::Trajectory::apply_transform)
+      .def("sample_grid", &WalkPatternGenerator::Trajectory::sample_grid);
+
+  class__<WalkPatternGenerator::Trajectory::Samples>("WalkTrajectorySamples")
+      .add_property(
+          "ts", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.ts; })
+      .add_property(
+          "com_pos", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.com_pos; })
+      .add_property(
+          "com_vel", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.com_vel; })
+      .add_property(
+          "com_acc", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.com_acc; })
+      .add_property(
+          "zmp", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.zmp; })
+      .add_property(
+          "dcm", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.dcm; })
+      .add_property(
+          "left_pos", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.left_pos; })
+      .add_property(
+          "left_yaw", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.left_yaw; })
+      .add_property(
+          "right_pos", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.right_pos; })
+      .add_property(
+          "right_yaw", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.right_yaw; })
+      .add_property(
+          "trunk_yaw", +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.trunk_yaw; })
+      .add_property(
+          "support_side",
+          +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.support_side; })
+      .add_property(
+          "support_is_both",
+          +[](const WalkPatternGenerator::Trajectory::Samples& samples) { return samples.support_is_both; });
 
   class__<WalkPatternGenerator>("WalkPatternGenerator", init<HumanoidRobot&, HumanoidParameters&>())
-      .def("plan", &WalkPatternGenerator::plan)
-      .def("replan", &WalkPatternGenerator::replan)
+      .def(
+          "plan",
+          +[](WalkPatternGenerator& wpg, std::vector<FootstepsPlanner::Support>& supports,
+              Eigen::Vector3d initial_com_world, double t_start) {
+            ScopedGILRelease release;
+            return wpg.plan(supports, initial_com_world, t_start);
+          })
+      .def(
+          "replan",
+          +[](WalkPatternGenerator& wpg, std::vector<FootstepsPlanner::Support>& supports,
+              WalkPatternGenerator::Trajectory& old_trajectory, double t_replan) {
+            ScopedGILRelease release;
+            return wpg.replan(supports, old_trajectory, t_replan);
+          })
       .def("can_replan_supports", &WalkPatternGenerator::can_replan_supports)
-      .def("replan_supports", &WalkPatternGenerator::replan_supports);
+      .def("replan_supports", &WalkPatternGenerator::replan_supports)
+      .def(
+          "plan_batch",
+          +[](WalkPatternGenerator& wpg, boost::python::list jobs, int threads, bool keep_trajectories) {
+            std::vector<WalkPatternGenerator::PlanJob> jobs_vector;
+            for (int k = 0; k < len(jobs); k++)
+            {
+              jobs_vector.push_back(extract<WalkPatternGenerator::PlanJob>(jobs[k]));
+            }
+
+            std::vector<WalkPatternGenerator::PlanResult> results;
+            {
+              ScopedGILRelease release;
+              results = wpg.plan_batch(jobs_vector, threads, keep_trajectories);
+            }
+
+            boost::python::list results_list;
+            for (auto& result : results)
+            {
+              results_list.append(result);
+            }
+            return results_list;
+          },
+          (arg("self"), arg("jobs"), arg("threads") = 0, arg("keep_trajectories") = true));
+
+  class__<WalkPatternGenerator::PlanJob>("WalkPlanJob")
+      .add_property("supports", &WalkPatternGenerator::PlanJob::supports, &WalkPatternGenerator::PlanJob::supports)
+      .add_property("parameters", &WalkPatternGenerator::PlanJob::parameters,
+                    &WalkPatternGenerator::PlanJob::parameters)
+      .add_property(
+          "initial_com_world", +[](const WalkPatternGenerator::PlanJob& job) { return job.initial_com_world; },
+          +[](WalkPatternGenerator::PlanJob& job, const Eigen::Vector3d& initial_com_world) {
+            job.initial_com_world = initial_com_world;
+          })
+      .add_property("t_start", &WalkPatternGenerator::PlanJob::t_start, &WalkPatternGenerator::PlanJob::t_start);
+
+  class__<WalkPatternGenerator::PlanResult>("WalkPlanResult")
+      .add_property("success", &WalkPatternGenerator::PlanResult::success)
+      .add_property("error", &WalkPatternGenerator::PlanResult::error)
+      .add_property("trajectory", &WalkPatternGenerator::PlanResult::trajectory)
+      .add_property("duration", &WalkPatternGenerator::PlanResult::duration)
+      .add_property("min_zmp_margin", &WalkPatternGenerator::PlanResult::min_zmp_margin)
+      .add_property("max_com_vel", &WalkPatternGenerator::PlanResult::max_com_vel)
+      .add_property("max_com_acc", &WalkPatternGenerator::PlanResult::max_com_acc);
 
   class__<SwingFoot>("SwingFoot", init<>())
       .def("make_trajectory", &SwingFoot::make_trajectory)
       .def("remake_trajectory", &SwingFoot::remake_trajectory);
 
   class__<SwingFootCubic::Trajectory>("SwingFootCubicTrajectory", init<>())
-      .def("pos", &SwingFootCubic::Trajectory::pos)
-      .def("vel", &SwingFootCubic::Trajectory::vel);
+      .def<Eigen::Vector3d (SwingFootCubic::Trajectory::*)(double)>("pos", &SwingFootCubic::Trajectory::pos)
+      .def<Eigen::Vector3d (SwingFootCubic::Trajectory::*)(double)>("vel", &SwingFootCubic::Trajectory::vel)
+      .def<Eigen::MatrixXd (SwingFootCubic::Trajectory::*)(const Eigen::VectorXd&)>("pos", &SwingFootCubic::Trajectory::pos)
+      .def<Eigen::MatrixXd (SwingFootCubic::Trajectory::*)(const Eigen::VectorXd&)>("vel", &SwingFootCubic::Trajectory::vel);
 
   class__<SwingFootCubic>("SwingFootCubic", init<>()).def("make_trajectory", &SwingFootCubic::make_trajectory);
 
   class__<SwingFoot::Trajectory>("SwingFootTrajectory", init<>())
-      .def("pos", &SwingFoot::Trajectory::pos)
-      .def("vel", &SwingFoot::Trajectory::vel);
+      .def<Eigen::Vector3d (SwingFoot::Trajectory::*)(double)>("pos", &SwingFoot::Trajectory::pos)
+      .def<Eigen::Vector3d (SwingFoot::Trajectory::*)(double)>("vel", &SwingFoot::Trajectory::vel)
+      .def<Eigen::MatrixXd (SwingFoot::Trajectory::*)(const Eigen::VectorXd&)>("pos", &SwingFoot::Trajectory::pos)
+      .def<Eigen::MatrixXd (SwingFoot::Trajectory::*)(const Eigen::VectorXd&)>("vel", &SwingFoot::Trajectory::vel);
 
   class__<SwingFootQuintic>("SwingFootQuintic", init<>()).def("make_trajectory", &SwingFootQuintic::make_trajectory);
 
   class__<SwingFootQuintic::Trajectory>("SwingFootQuinticTrajectory", init<>())
-      .def("pos", &SwingFootQuintic::Trajectory::pos)
-      .def("vel", &SwingFootQuintic::Trajectory::vel);
+      .def<Eigen::Vector3d (SwingFootQuintic::Trajectory::*)(double)>("pos", &SwingFootQuintic::Trajectory::pos)
+      .def<Eigen::Vector3d (SwingFootQuintic::Trajectory::*)(double)>("vel", &SwingFootQuintic::Trajectory::vel)
+      .def<Eigen::MatrixXd (SwingFootQuintic::Trajectory::*)(const Eigen::VectorXd&)>("pos", &SwingFootQuintic::Trajectory::pos)
+      .def<Eigen::MatrixXd (SwingFootQuintic::Trajectory::*)(const Eigen::VectorXd&)>("vel", &SwingFootQuintic::Trajectory::vel);
 
   class__<WalkTasks>("WalkTasks", init<>())
       .def(
@@ -132,6 +224,7 @@ void exposeWalkPatternGenerator()
       .def("dcm", &LIPM::dcm)
       .def("compute_omega", &LIPM::compute_omega)
       .def("get_trajectory", &LIPM::get_trajectory)
+      .def("set_initial_state", &LIPM::set_initial_state)
       .add_property("x", &LIPM::x)
       .add_property("y", &LIPM::y);
 }
\ No newline at end of file
@@ -40,6 +40,104 @@ class TestLIPM(unittest.TestCase):
         self.assertFalse(footstep1.overlap(footstep3, 0.))
         self.assertTrue(footstep1.overlap(footstep3, 0.15))
 
+        # Crossing footsteps overlap, even if no corner is inside the other footstep
+        footstep4 = placo.Footstep(0.05, 0.1)
+        footstep4.frame = tf.rotation_matrix(np.pi / 2, (0., 0., 1.))
+        self.assertTrue(footstep1.overlap(footstep4, 0.))
+
+    def test_incremental_planning(self):
+        """
+        In incremental mode, the committed footsteps of the previous plan are kept
+        """
+        parameters = placo.HumanoidParameters()
+        planner = placo.FootstepsPlannerRepetitive(parameters)
+        planner.configure(0.05, 0.0, 0.0, 6)
+        planner.incremental = True
+        planner.committed_steps = 1
+
+        T_world_left = tf.translation_matrix((0.0, parameters.feet_spacing / 2, 0.0))
+        T_world_right = tf.translation_matrix((0.0, -parameters.feet_spacing / 2, 0.0))
+        footsteps = planner.plan(placo.HumanoidRobot_Side.left, T_world_left, T_world_right)
+
+        # Replanning with a different step size once the first step is done
+        planner.configure(0.02, 0.0, 0.0, 6)
+        T_world_left, T_world_right = footsteps[2].frame, footsteps[1].frame
+        new_footsteps = planner.plan(placo.HumanoidRobot_Side.right, T_world_left, T_world_right)
+
+        self.assertNumpyEqual(new_footsteps[2].frame, footsteps[3].frame)
+        self.assertFalse(np.allclose(new_footsteps[3].frame, footsteps[4].frame))
+
+        # Polygons reused from the previous supports are the same as the computed ones
+        supports = placo.FootstepsPlanner.make_supports(footsteps, True, False, True)
+        for support in supports:
+            support.support_polygon()
+        new_supports = placo.FootstepsPlanner.make_supports(new_footsteps, True, False, True)
+        placo.FootstepsPlanner.reuse_polygons(new_supports, supports)
+        fresh_supports = placo.FootstepsPlanner.make_supports(new_footsteps, True, False, True)
+        for support, fresh_support in zip(new_supports, fresh_supports):
+            for point, expected in zip(support.support_polygon(), fresh_support.support_polygon()):
+                self.assertNumpyEqual(point, expected)
+
+        # The kept footsteps count in the planned steps, so that replanning doesn't make the plan longer
+        self.assertEqual(len(new_footsteps), len(footsteps))
+        for k in range(5):
+            T_world_left, T_world_right = new_footsteps[2].frame, new_footsteps[1].frame
+            if new_footsteps[2].side == placo.HumanoidRobot_Side.right:
+                T_world_left, T_world_right = T_world_right, T_world_left
+            new_footsteps = planner.plan(new_footsteps[1].side, T_world_left, T_world_right)
+            self.assertEqual(len(new_footsteps), len(footsteps))
+
+    def test_search_planner(self):
+        """
+        The search planner reaches the target while avoiding the obstacles of the cost map
+        """
+        parameters = placo.HumanoidParameters()
+        planner = placo.FootstepsPlannerSearch(parameters)
+        planner.max_time = 1.0
+
+        T_world_left = tf.translation_matrix((0.0, parameters.feet_spacing / 2, 0.0))
+        T_world_right = tf.translation_matrix((0.0, -parameters.feet_spacing / 2, 0.0))
+        T_world_left_target = tf.translation_matrix((1.0, parameters.feet_spacing / 2, 0.0))
+        T_world_right_target = tf.translation_matrix((1.0, -parameters.feet_spacing / 2, 0.0))
+        planner.configure(T_world_left_target, T_world_right_target)
+
+        # Wall for x in [0.4, 0.6] and y in [-0.3, 0.5]
+        cost_map = np.zeros((100, 100))
+        cost_map[45:55, 10:50] = 2.0
+        planner.set_cost_map(cost_map, np.array([-0.5, -0.5]), 0.02)
+
+        footsteps = planner.plan(placo.HumanoidRobot_Side.left, T_world_left, T_world_right)
+        self.assertGreater(planner.solution_epsilon, 0.0)
+
+        # No point of the feet is on an obstacle
+        for footstep in footsteps:
+            for sx in np.linspace(-1.0, 1.0, 21):
+                for sy in np.linspace(-1.0, 1.0, 21):
+                    point = footstep.frame @ np.array(
+                        [sx * footstep.foot_length / 2, sy * footstep.foot_width / 2, 0.0, 1.0]
+                    )
+                    self.assertLess(planner.map_cost(point[:2]), planner.obstacle_threshold)
+
+        # Each footstep is reached from the previous one with a step within the limits
+        for previous, footstep in zip(footsteps[1:-1], footsteps[2:]):
+            self.assertNotEqual(previous.side, footstep.side)
+            offset = parameters.feet_spacing if previous.side == placo.HumanoidRobot_Side.right else -parameters.feet_spacing
+            T_neutral_footstep = np.linalg.inv(previous.frame @ tf.translation_matrix((0.0, offset, 0.0))) @ footstep.frame
+            step = np.array(
+                [T_neutral_footstep[0, 3], T_neutral_footstep[1, 3], np.arctan2(T_neutral_footstep[1, 0], T_neutral_footstep[0, 0])]
+            )
+            self.assertNumpyEqual(parameters.ellipsoid_clip(step), step)
+            self.assertFalse(previous.overlap(footstep, 0.0))
+
+        # Positions outside of the map are obstacles
+        self.assertGreaterEqual(planner.map_cost(np.array([-1.0, 0.0])), planner.obstacle_threshold)
+
+        # The last footstep is placed next to the one reaching its target
+        targets = {placo.HumanoidRobot_Side.left: T_world_left_target, placo.HumanoidRobot_Side.right: T_world_right_target}
+        for footstep, tolerance in zip(footsteps[-2:], [planner.goal_tolerance, 0.05]):
+            error = footstep.frame[:2, 3] - targets[footstep.side][:2, 3]
+            self.assertLess(np.linalg.norm(error), tolerance + 1e-6)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -167,6 +167,28 @@ class TestProblem(unittest.TestCase):
         # Testing that inequality is still enforced
         self.assertTrue(integrator.value(0.5, 0) <= -5.0)
 
+    def test_integrator_trajectory_values(self):
+        problem = placo.Problem()
+        x = problem.add_variable(10)
+        integrator = placo.Integrator(x, np.array([1.0, 2.0, 3.0]), 3, 0.1)
+
+        problem.add_constraint(integrator.expr(10, 0) == 4.0)
+        problem.add_constraint(integrator.expr(10, 1) == 5.0)
+        problem.add_constraint(integrator.expr(10, 2) == 6.0)
+        problem.solve()
+
+        trajectory = integrator.get_trajectory()
+        ts = np.linspace(0.0, 1.0, 37)
+
+        for diff in range(4):
+            values = trajectory.values(ts, diff)
+            for t, value in zip(ts, values):
+                self.assertNumpyEqual(value, trajectory.value(t, diff))
+
+                # Closed-form evaluation should match the matrix exponential used by expr_t
+                if diff < 3:
+                    self.assertNumpyEqual(value, integrator.expr_t(t, diff).value(x.value))
+
     def test_integrator_expr_x0(self):
         # Creating a problem
         problem = placo.Problem()
@@ -244,6 +266,26 @@ class TestProblem(unittest.TestCase):
             msg="The [3., 3.] value should be projected in the polygon top-right corner at [2., 2.]",
         )
 
+    def test_half_planes(self):
+        """
+        Half-planes computed once can constrain several points with one stacked constraint
+        """
+        problem = placo.Problem()
+        polygon = np.array([[1.0, 1.0], [1.0, 2.0], [2.0, 2.0], [2.0, 1.0]])
+        half_planes = placo.HalfPlanes(polygon, 0.1)
+
+        a = problem.add_variable(2)
+        b = problem.add_variable(2)
+        constraint = problem.add_constraint(half_planes.apply_all([a.expr(), b.expr()]))
+        self.assertEqual(constraint.expression.rows(), 8)
+
+        problem.add_constraint(a.expr() == np.array([0.0, 0.0])).configure("soft", 1.0)
+        problem.add_constraint(b.expr() == np.array([3.0, 3.0])).configure("soft", 1.0)
+        problem.solve()
+
+        self.assertNumpyEqual(a.value, np.array([1.1, 1.1]))
+        self.assertNumpyEqual(b.value, np.array([1.9, 1.9]))
+
     def test_problem_overconstrained(self):
         """
         Checking that overconstrained equalities solve raise an exception
@@ -355,6 +397,35 @@ class TestProblem(unittest.TestCase):
         self.assertTrue(cst2.is_active)
         self.assertFalse(cst3.is_active)
 
+    def test_warm_start(self):
+        """
+        Warm starting from the active rows of a previous solve gives the same solution without calling the QP solver,
+        and wrong guesses are discarded
+        """
+
+        def solve(guess=None):
+            problem = placo.Problem()
+            x = problem.add_variable(2)
+            problem.add_constraint(x.expr() == np.array([1.0, 2.0])).configure("soft", 1.0)
+            constraint = problem.add_constraint(x.expr() <= np.array([0.5, 3.0]))
+            if guess is not None:
+                problem.warm_start = True
+                constraint.active_rows = guess
+            problem.solve()
+
+            return problem, constraint, x.value
+
+        problem, constraint, x = solve()
+        self.assertFalse(problem.warm_started)
+        self.assertEqual(list(constraint.active_rows), [0])
+        self.assertNumpyEqual(x, np.array([0.5, 2.0]))
+
+        for guess, warm_started in [([0], True), ([1], False), ([0, 1], False), ([5], False)]:
+            problem, constraint, warm_x = solve(guess)
+            self.assertEqual(problem.warm_started, warm_started, msg=f"guess={guess}")
+            self.assertEqual(list(constraint.active_rows), [0])
+            self.assertNumpyEqual(warm_x, x)
+
     def test_exactly_constrained(self):
         """
         Testing what happens if a problem is *exactly* constrained
@@ -1,16 +1,55 @@
 import unittest
 import placo
 import os
+import shutil
+import tempfile
+import threading
 import numpy as np
+import pinocchio as pin
 from placo_utils.tf import tf
 
 this_dir = os.path.dirname(os.path.realpath(__file__))
 
 
+def brute_force_distances(robot):
+    """
+    Distances of all the collision pairs, computed with pinocchio on fresh data
+    """
+    geom_data = pin.GeometryData(robot.collision_model)
+    pin.updateGeometryPlacements(robot.model, pin.Data(robot.model), robot.collision_model, geom_data, robot.state.q)
+
+    distances = {}
+    for k, pair in enumerate(robot.collision_model.collisionPairs):
+        distances[(pair.first, pair.second)] = pin.computeDistance(robot.collision_model, geom_data, k).min_distance
+
+    return distances
+
+
+def randomize_joints(robot, amplitude=1.0):
+    for name in robot.joint_names():
+        robot.set_joint(name, np.random.uniform(-amplitude, amplitude))
+    robot.update_kinematics()
+
+
 class TestWrapper(unittest.TestCase):
     def setUp(self):
         self.robot = placo.RobotWrapper(f"{this_dir}/quadruped/robot.urdf", placo.Flags.collision_as_visual)
 
+    def copy_robot(self):
+        """
+        Copies the quadruped to a temporary directory (removed after the test), so that the caches written next to
+        its URDF don't depend on previous runs
+        """
+        directory = tempfile.TemporaryDirectory()
+        self.addCleanup(directory.cleanup)
+        shutil.copytree(
+            f"{this_dir}/quadruped",
+            f"{directory.name}/quadruped",
+            ignore=shutil.ignore_patterns(".placo_cache", "*.convex"),
+        )
+
+        return f"{directory.name}/quadruped/robot.urdf"
+
     def test_wrapper(self):
         """
         Performs basic checks on the wrapper
@@ -109,6 +148,312 @@ class TestWrapper(unittest.TestCase):
             np.linalg.norm(self.robot.get_T_world_frame("body") - T_world_body), 0.0, msg="Body frame should be identity"
         )
 
+    def test_prune_collision_pairs(self):
+        """
+        Pruning the collision pairs, writing them to a file and loading them back
+        """
+        n_pairs = len(self.robot.collision_model.collisionPairs)
+        filename = f"{tempfile.mkdtemp()}/collisions.json"
+
+        kept = self.robot.prune_collision_pairs(filename, 100)
+        self.assertLessEqual(kept, n_pairs, msg="Pruning should not add collision pairs")
+        self.assertEqual(kept, len(self.robot.collision_model.collisionPairs))
+
+        self.robot.load_collision_pairs(filename)
+        self.assertEqual(kept, len(self.robot.collision_model.collisionPairs), msg="Pruned pairs should be reloaded")
+
+    def test_convex_collisions(self):
+        """
+        Convex hulls can only be closer than the original meshes
+        """
+        urdf_filename = self.copy_robot()
+
+        for _ in range(2):
+            # The second time, the hulls are loaded from the cache
+            convex_robot = placo.RobotWrapper(
+                urdf_filename, placo.Flags.collision_as_visual | placo.Flags.convex_collisions
+            )
+
+            distances = {(d.objA, d.objB): d.min_distance for d in self.robot.distances()}
+            convex_distances = {(d.objA, d.objB): d.min_distance for d in convex_robot.distances()}
+            self.assertEqual(distances.keys(), convex_distances.keys())
+
+            for pair in distances:
+                self.assertLessEqual(convex_distances[pair], distances[pair] + 1e-6)
+
+    def test_convex_cache_corrupted(self):
+        """
+        A truncated or corrupted convex hulls cache should be ignored and rebuilt
+        """
+        urdf_filename = self.copy_robot()
+        flags = placo.Flags.collision_as_visual | placo.Flags.convex_collisions
+        expected = {(d.objA, d.objB): d.min_distance for d in placo.RobotWrapper(urdf_filename, flags).distances()}
+
+        with open(f"{urdf_filename}.convex", "rb") as f:
+            content = f.read()
+
+        # Truncated files, and a huge name size right after the header
+        corruptions = [content[:size] for size in [4, 8, 10, len(content) // 2, len(content) - 1]]
+        corruptions.append(content[:8] + b"\xff\xff\xff\xff" + content[12:])
+
+        for corruption in corruptions:
+            with open(f"{urdf_filename}.convex", "wb") as f:
+                f.write(corruption)
+
+            robot = placo.RobotWrapper(urdf_filename, flags)
+            distances = {(d.objA, d.objB): d.min_distance for d in robot.distances()}
+            self.assertEqual(distances.keys(), expected.keys())
+            for pair in expected:
+                self.assertAlmostEqual(distances[pair], expected[pair])
+
+            self.assertEqual(os.path.getsize(f"{urdf_filename}.convex"), len(content), msg="The cache should be rebuilt")
+
+    def test_model_cache(self):
+        """
+        A robot loaded from the model cache should be the same as the original one
+        """
+        urdf_filename = self.copy_robot()
+
+        for _ in range(2):
+            # The first load writes the cache, the second one reads it
+            cached_robot = placo.RobotWrapper(urdf_filename, placo.Flags.collision_as_visual | placo.Flags.model_cache)
+
+            self.assertEqual(list(self.robot.frame_names()), list(cached_robot.frame_names()))
+            self.assertEqual(len(self.robot.collision_model.collisionPairs), len(cached_robot.collision_model.collisionPairs))
+
+            for robot in [self.robot, cached_robot]:
+                robot.set_joint("leg3_a", 1.0)
+                robot.update_kinematics()
+            self.assertAlmostEqual(
+                np.linalg.norm(self.robot.get_T_world_frame("tip") - cached_robot.get_T_world_frame("tip")), 0.0
+            )
+            distances = sorted(d.min_distance for d in self.robot.distances())
+            cached_distances = sorted(d.min_distance for d in cached_robot.distances())
+            self.assertTrue(np.allclose(distances, cached_distances))
+
+    def test_model_cache_corrupted(self):
+        """
+        A truncated or corrupted model cache should be ignored and rebuilt
+        """
+        urdf_filename = self.copy_robot()
+        flags = placo.Flags.collision_as_visual | placo.Flags.model_cache
+        cache_dir = f"{os.path.dirname(urdf_filename)}/.placo_cache"
+        placo.RobotWrapper(urdf_filename, flags)
+
+        contents = {}
+        for name in os.listdir(cache_dir):
+            with open(f"{cache_dir}/{name}", "rb") as f:
+                contents[name] = f.read()
+
+        for name, content in contents.items():
+            # Truncated files, and for the geometry file, huge sizes in place of the first words after the version
+            # (the model file is read by pinocchio)
+            corruptions = [content[:size] for size in [2, 6, len(content) // 3, len(content) // 2, len(content) - 1]]
+            if name.endswith(".geometry"):
+                corruptions += [content[:offset] + b"\xff\xff\xff\xff" + content[offset + 4 :] for offset in [4, 8, 12]]
+
+            for corruption in corruptions:
+                with open(f"{cache_dir}/{name}", "wb") as f:
+                    f.write(corruption)
+
+                robot = placo.RobotWrapper(urdf_filename, flags)
+                self.assertEqual(list(self.robot.frame_names()), list(robot.frame_names()))
+                self.assertEqual(
+                    len(self.robot.collision_model.collisionPairs), len(robot.collision_model.collisionPairs)
+                )
+
+                for cache_name in contents:
+                    self.assertEqual(
+                        os.path.getsize(f"{cache_dir}/{cache_name}"),
+                        len(contents[cache_name]),
+                        msg="The cache should be rebuilt",
+                    )
+                self.assertFalse(
+                    any(".tmp" in name for name in os.listdir(cache_dir)), msg="No temporary file should remain"
+                )
+
+    def test_lazy_visual(self):
+        """
+        With the lazy_visual flag, the visual model is loaded on first access
+        """
+        robot = placo.RobotWrapper(f"{this_dir}/quadruped/robot.urdf", placo.Flags.lazy_visual)
+        self.assertEqual(
+            robot.visual_model.ngeoms, placo.RobotWrapper(f"{this_dir}/quadruped/robot.urdf").visual_model.ngeoms
+        )
+        self.assertGreater(robot.visual_model.ngeoms, 0)
+
+    def test_lazy_visual_model_cache(self):
+        """
+        With both the lazy_visual and model_cache flags, the visual model is still loaded on first access
+        """
+        expected = placo.RobotWrapper(f"{this_dir}/quadruped/robot.urdf").visual_model.ngeoms
+
+        urdf_filename = self.copy_robot()
+
+        for _ in range(2):
+            # The first load writes the cache, the second one reads it
+            robot = placo.RobotWrapper(urdf_filename, placo.Flags.lazy_visual | placo.Flags.model_cache)
+            self.assertEqual(robot.visual_model.ngeoms, expected)
+
+    def test_shared_model(self):
+        """
+        Robots created from another one share its geometries but have their own model and state
+        """
+        robot = placo.RobotWrapper(self.robot)
+        self.assertEqual(robot.collision_model.ngeoms, self.robot.collision_model.ngeoms)
+
+        offset = self.robot.get_joint_offset("leg3_a")
+        lower_limit = self.robot.model.lowerPositionLimit[offset]
+        robot.set_joint_limits("leg3_a", lower_limit + 0.1, lower_limit + 0.2)
+        self.assertAlmostEqual(robot.model.lowerPositionLimit[offset], lower_limit + 0.1)
+        self.assertAlmostEqual(
+            self.robot.model.lowerPositionLimit[offset], lower_limit, msg="The model should not be shared"
+        )
+
+        T_world_tip = self.robot.get_T_world_frame("tip")
+        robot.set_joint("leg3_a", 1.0)
+        robot.update_kinematics()
+
+        self.assertAlmostEqual(self.robot.get_joint("leg3_a"), 0.0, msg="The original robot state should not change")
+        self.assertAlmostEqual(np.linalg.norm(self.robot.get_T_world_frame("tip") - T_world_tip), 0.0)
+        self.assertGreater(np.linalg.norm(robot.get_T_world_frame("tip") - T_world_tip), 0.05)
+
+    def test_joint_selection(self):
+        """
+        Setting and getting several joints at once
+        """
+        names = ["leg1_a", "leg2_b", "leg3_c"]
+        selection = self.robot.joint_selection(names)
+
+        self.robot.set_joints(selection, np.array([0.1, 0.2, 0.3]))
+        self.robot.set_joint_velocities(selection, np.array([1.0, 2.0, 3.0]))
+
+        for name, value, velocity in zip(names, [0.1, 0.2, 0.3], [1.0, 2.0, 3.0]):
+            self.assertAlmostEqual(self.robot.get_joint(name), value)
+            self.assertAlmostEqual(self.robot.get_joint_velocity(name), velocity)
+
+        self.assertTrue(np.allclose(self.robot.get_joints(selection), [0.1, 0.2, 0.3]))
+        self.assertTrue(np.allclose(self.robot.get_joint_velocities(selection), [1.0, 2.0, 3.0]))
+
+    def test_state_view(self):
+        """
+        The state views are numpy views on the robot state, while the state vectors are copies
+        """
+        q_copy = self.robot.state.q
+        q = self.robot.state.q_view
+        q[self.robot.get_joint_offset("leg3_a")] = 1.0
+        self.assertAlmostEqual(self.robot.get_joint("leg3_a"), 1.0, msg="Writing to the view should update the state")
+
+        self.robot.set_joint("leg3_a", 0.5)
+        self.assertAlmostEqual(q[self.robot.get_joint_offset("leg3_a")], 0.5, msg="The view should see state updates")
+
+        self.robot.reset()
+        self.assertAlmostEqual(q[self.robot.get_joint_offset("leg3_a")], 0.0, msg="The view should survive a reset")
+        self.assertAlmostEqual(q_copy[self.robot.get_joint_offset("leg3_a")], 0.0, msg="The copy should not change")
+
+        q_copy[self.robot.get_joint_offset("leg3_a")] = 1.0
+        self.assertAlmostEqual(self.robot.get_joint("leg3_a"), 0.0, msg="Writing to the copy should not change the state")
+
+    def test_distances_reuse(self):
+        """
+        Distances computed with the collision data kept across calls should match the ones of fresh data
+        """
+        np.random.seed(0)
+
+        for _ in range(10):
+            randomize_joints(self.robot)
+
+            distances = {(d.objA, d.objB): d.min_distance for d in self.robot.distances()}
+            expected = brute_force_distances(self.robot)
+            self.assertEqual(distances.keys(), expected.keys())
+
+            for pair in expected:
+                self.assertAlmostEqual(distances[pair], expected[pair], 6)
+
+    def test_distances_broad_phase(self):
+        """
+        With a maximum distance, the pairs culled by the bounding spheres should be exactly the farther ones
+        """
+        np.random.seed(1)
+        max_distance = 0.02
+
+        for _ in range(10):
+            # A fresh copy is used so that only the broad phase (and not the previous calls) culls pairs
+            robot = placo.RobotWrapper(self.robot)
+            randomize_joints(robot)
+
+            distances = {(d.objA, d.objB): d.min_distance for d in robot.distances(max_distance)}
+            expected = {pair: d for pair, d in brute_force_distances(robot).items() if d < max_distance}
+            self.assertEqual(distances.keys(), expected.keys())
+
+            for pair in expected:
+                self.assertAlmostEqual(distances[pair], expected[pair], 6)
+
+    def test_distances_temporal_coherence(self):
+        """
+        Along a random motion, the distances culled using the bounds of the previous calls should match brute force,
+        also when the collision pairs are changed in the middle of the motion
+        """
+        np.random.seed(2)
+        max_distance = 0.02
+        filename = f"{tempfile.mkdtemp()}/collisions.json"
+        q = self.robot.state.q.copy()
+
+        for step in range(60):
+            if step == 20:
+                self.robot.prune_collision_pairs(filename, 20)
+            if step == 40:
+                self.robot.load_collision_pairs(filename)
+
+            q[7:] += np.random.uniform(-0.1, 0.1, len(q) - 7)
+            self.robot.state.q = q
+            self.robot.update_kinematics()
+
+            distances = {(d.objA, d.objB): d.min_distance for d in self.robot.distances(max_distance)}
+            expected = {pair: d for pair, d in brute_force_distances(self.robot).items() if d < max_distance}
+            self.assertEqual(distances.keys(), expected.keys(), msg=f"Step {step}")
+
+            for pair in expected:
+                self.assertAlmostEqual(distances[pair], expected[pair], 6)
+
+    def test_concurrent_calls(self):
+        """
+        Calls releasing the GIL can run concurrently on robots sharing the same model
+        """
+        np.random.seed(3)
+        configurations = []
+        for _ in range(20):
+            randomize_joints(self.robot)
+            configurations.append(self.robot.state.q.copy())
+
+        def compute(robot, results):
+            for q in configurations:
+                robot.state.q = q
+                robot.update_kinematics()
+                results.append(sorted(d.min_distance for d in robot.distances()))
+
+        expected = []
+        compute(self.robot, expected)
+
+        results = [[] for _ in range(4)]
+        threads = [
+            threading.Thread(target=compute, args=(placo.RobotWrapper(self.robot), result)) for result in results
+        ]
+        for thread in threads:
+            thread.start()
+
+        # The main thread keeps calling into placo while the other threads are computing
+        main_results = []
+        compute(placo.RobotWrapper(self.robot), main_results)
+
+        for thread in threads:
+            thread.join()
+
+        for result in results + [main_results]:
+            self.assertEqual(len(result), len(expected))
+            for distances, expected_distances in zip(result, expected):
+                self.assertTrue(np.allclose(distances, expected_distances))
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -92,6 +92,27 @@ class TestSwingFoot(unittest.TestCase):
         vel_new = new_trajectory.vel(2.0)[:2]
         self.assertAlmostEqual(np.linalg.norm(vel_new), 0.0, msg="The new trajectory should end with zero velocity")
 
+    def test_swing_batch(self):
+        """
+        Batch evaluation should match the evaluation at each time
+        """
+        initial, target = np.array([0.0, 0.0, 0.0]), np.array([1.0, 0.25, 0.0])
+        trajectories = [
+            placo.SwingFoot.make_trajectory(0.5, 2.0, 0.25, initial, target),
+            placo.SwingFootCubic.make_trajectory(0.5, 2.0, 0.25, 0.2, initial, target),
+            placo.SwingFootQuintic.make_trajectory(0.5, 2.0, 0.25, initial, target),
+        ]
+        ts = np.linspace(0.5, 2.0, 50)
+
+        for trajectory in trajectories:
+            positions = trajectory.pos(ts)
+            velocities = trajectory.vel(ts)
+            self.assertEqual(positions.shape, (3, len(ts)))
+
+            for k, t in enumerate(ts):
+                self.assertAlmostEqual(np.linalg.norm(positions[:, k] - trajectory.pos(t)), 0.0)
+                self.assertAlmostEqual(np.linalg.norm(velocities[:, k] - trajectory.vel(t)), 0.0)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -34,6 +34,56 @@ class TestUtils(unittest.TestCase):
             vel = spline.vel(t)
             self.assertNumpyEqual(vel, vel_fd)
 
+    def test_cubic_spline_lookup(self):
+        """
+        Checks that the spline gives the same values whatever the order of the queries
+        """
+        spline = placo.CubicSpline()
+        for k in range(20):
+            spline.add_point(k * 0.5, np.sin(k), np.cos(k))
+
+        ts = np.linspace(-1.0, 11.0, 200)
+        values = [spline.pos(t) for t in ts]
+
+        for k in np.random.permutation(len(ts)):
+            self.assertNumpyEqual(spline.pos(ts[k]), values[k])
+
+        for k in range(20):
+            self.assertNumpyEqual(spline.pos(k * 0.5), np.sin(k))
+            self.assertNumpyEqual(spline.vel(k * 0.5), np.cos(k))
+
+    def test_cubic_spline_fit(self):
+        """
+        Checks the Hermite coefficients against the generic fit (solving the 4x4 system on each segment)
+        """
+
+        def fit(t1, x1, dx1, t2, x2, dx2):
+            M = np.array(
+                [
+                    [t1**3, t1**2, t1, 1.0],
+                    [3 * t1**2, 2 * t1, 1.0, 0.0],
+                    [t2**3, t2**2, t2, 1.0],
+                    [3 * t2**2, 2 * t2, 1.0, 0.0],
+                ]
+            )
+            return np.linalg.inv(M) @ np.array([x1, dx1, x2, dx2])
+
+        np.random.seed(0)
+        ts = np.cumsum(np.random.uniform(0.01, 1.0, 20))
+        xs = np.random.uniform(-2.0, 2.0, 20)
+        dxs = np.random.uniform(-5.0, 5.0, 20)
+
+        spline = placo.CubicSpline()
+        for t, x, dx in zip(ts, xs, dxs):
+            spline.add_point(t, x, dx)
+
+        for k in range(1, len(ts)):
+            a, b, c, d = fit(0.0, xs[k - 1], dxs[k - 1], ts[k] - ts[k - 1], xs[k], dxs[k])
+            for t in np.linspace(ts[k - 1], ts[k], 10):
+                dt = t - ts[k - 1]
+                self.assertNumpyEqual(spline.pos(t), a * dt**3 + b * dt**2 + c * dt + d)
+                self.assertNumpyEqual(spline.vel(t), 3 * a * dt**2 + 2 * b * dt + c)
+
     def test_angle_spline(self):
         """
         Tests angle wrapping for angular splines
@@ -52,6 +102,84 @@ class TestUtils(unittest.TestCase):
         spline.add_point(6.6, -1.4, 0.0)
         self.assertTrue(spline.pos(6.4) > 4.58)
 
+    def make_polygon(self, points):
+        return placo.Polygon2d([np.array(point, dtype=float) for point in points])
+
+    def signed_area(self, polygon):
+        points = np.array([polygon.point(k) for k in range(polygon.size())])
+        next_points = np.roll(points, -1, axis=0)
+        return np.sum(points[:, 0] * next_points[:, 1] - next_points[:, 0] * points[:, 1]) / 2
+
+    def test_polygon_hull(self):
+        """
+        The convex hull removes collinear, duplicate and inner points, and is clockwise
+        """
+        points = [[0.0, 0.0], [0.5, 0.0], [1.0, 0.0], [1.0, 0.0], [1.0, 1.0], [0.0, 1.0], [0.0, 0.5], [0.5, 0.5]]
+        hull = self.make_polygon(points).convex_hull()
+
+        self.assertEqual(hull.size(), 4)
+        for k, expected in enumerate([[0.0, 0.0], [0.0, 1.0], [1.0, 1.0], [1.0, 0.0]]):
+            self.assertNumpyEqual(hull.point(k), np.array(expected))
+
+        np.random.seed(0)
+        for _ in range(20):
+            points = np.random.uniform(-1.0, 1.0, (8, 2))
+            hull = self.make_polygon(points).convex_hull()
+
+            self.assertGreaterEqual(hull.size(), 3)
+            self.assertLess(self.signed_area(hull), 0.0)
+            for point in points:
+                self.assertTrue(hull.contains(point, -1e-9))
+
+    def test_polygon_contains(self):
+        """
+        Checking if points are in a polygon, with a margin to the edges
+        """
+        square = self.make_polygon([[0.0, 0.0], [0.0, 1.0], [1.0, 1.0], [1.0, 0.0]])
+
+        self.assertTrue(square.contains(np.array([0.5, 0.5])))
+        self.assertTrue(square.contains(np.array([0.5, 0.5]), 0.4))
+        self.assertFalse(square.contains(np.array([0.5, 0.5]), 0.6))
+        self.assertTrue(square.contains(np.array([1.0, 0.5])))
+        self.assertFalse(square.contains(np.array([1.0, 0.5]), 0.01))
+        self.assertTrue(square.contains(np.array([1.005, 0.5]), -0.01))
+        self.assertFalse(square.contains(np.array([1.1, 0.5])))
+
+    def test_polygon_overlap(self):
+        """
+        Overlap of convex polygons, using the separating axis theorem
+        """
+        a = self.make_polygon([[0.0, 0.0], [0.0, 1.0], [1.0, 1.0], [1.0, 0.0]])
+
+        self.assertTrue(a.overlap(self.make_polygon([[0.9, 0.9], [0.9, 2.0], [2.0, 2.0], [2.0, 0.9]])))
+        self.assertFalse(a.overlap(self.make_polygon([[1.1, 1.1], [1.1, 2.0], [2.0, 2.0], [2.0, 1.1]])))
+
+        # Touching polygons overlap
+        self.assertTrue(a.overlap(self.make_polygon([[1.0, 0.0], [1.0, 1.0], [2.0, 1.0], [2.0, 0.0]])))
+
+        # Crossing rectangles overlap, even if no point of one is inside the other
+        horizontal = self.make_polygon([[-2.0, -1.0], [-2.0, 1.0], [2.0, 1.0], [2.0, -1.0]])
+        vertical = self.make_polygon([[-1.0, -2.0], [-1.0, 2.0], [1.0, 2.0], [1.0, -2.0]])
+        self.assertTrue(horizontal.overlap(vertical))
+
+        # Triangles separated along their diagonal edge, while their bounding boxes overlap
+        triangle = self.make_polygon([[0.0, 0.0], [0.0, 1.0], [1.0, 0.0]])
+        other_triangle = self.make_polygon([[0.6, 0.6], [0.6, 1.6], [1.6, 0.6]])
+        self.assertFalse(triangle.overlap(other_triangle))
+        self.assertFalse(other_triangle.overlap(triangle))
+
+        self.assertFalse(a.overlap(placo.Polygon2d()))
+
+    def test_polygon_degenerate(self):
+        """
+        Half-planes can't be computed for degenerate polygons
+        """
+        with self.assertRaises(RuntimeError):
+            self.make_polygon([[0.0, 0.0], [1.0, 0.0]]).contains(np.array([0.5, 0.0]))
+
+        with self.assertRaises(RuntimeError):
+            self.make_polygon([[0.0, 0.0], [0.0, 0.0], [0.0, 1.0], [1.0, 1.0]]).contains(np.array([0.2, 0.5]))
+
 
 if __name__ == "__main__":
     unittest.main()
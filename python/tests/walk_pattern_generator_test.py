@@ -0,0 +1,225 @@
+import unittest
+import placo
+import numpy as np
+import os
+from placo_utils.tf import tf
+
+this_dir = os.path.dirname(os.path.realpath(__file__))
+
+
+def polygon_distance(polygon, point):
+    """
+    Signed distance from a point to the edges of a convex polygon (positive inside)
+    """
+    polygon = np.array(list(polygon))
+    edges = np.roll(polygon, -1, axis=0) - polygon
+    orientation = np.sign(np.sum(polygon[:, 0] * edges[:, 1] - polygon[:, 1] * edges[:, 0]))
+
+    distances = []
+    for a, edge in zip(polygon, edges):
+        normal = orientation * np.array([-edge[1], edge[0]]) / np.linalg.norm(edge)
+        distances.append(normal @ (point - a))
+
+    return min(distances)
+
+
+class TestWalkPatternGenerator(unittest.TestCase):
+    def setUp(self):
+        self.robot = placo.HumanoidRobot(f"{this_dir}/sigmaban/robot.urdf", placo.Flags.collision_as_visual)
+
+        self.parameters = placo.HumanoidParameters()
+        self.parameters.single_support_duration = 0.38
+        self.parameters.single_support_timesteps = 10
+        self.parameters.double_support_ratio = 0.0
+        self.parameters.startend_double_support_ratio = 1.5
+        self.parameters.planned_timesteps = 48
+        self.parameters.walk_com_height = 0.32
+        self.parameters.feet_spacing = 0.122
+        self.parameters.foot_length = 0.1576
+        self.parameters.foot_width = 0.092
+
+        self.planner = placo.FootstepsPlannerRepetitive(self.parameters)
+        self.planner.configure(0.05, 0.0, 0.1, 8)
+
+    def assertNumpyEqual(self, a, b, msg=None, epsilon=1e-6):
+        if msg is None:
+            msg = f"Checking that {a} equals {b}"
+        self.assertTrue(np.linalg.norm(a - b) < epsilon, msg=msg)
+
+    def make_supports(self, x=0.0):
+        T_world_left = tf.translation_matrix((x, self.parameters.feet_spacing / 2, 0.0))
+        T_world_right = tf.translation_matrix((x, -self.parameters.feet_spacing / 2, 0.0))
+        footsteps = self.planner.plan(placo.HumanoidRobot_Side.left, T_world_left, T_world_right)
+
+        return placo.FootstepsPlanner.make_supports(footsteps, True, self.parameters.has_double_support(), True)
+
+    def initial_com(self, x=0.0):
+        return np.array([x, 0.0, self.parameters.walk_com_height])
+
+    def omega(self):
+        return np.sqrt(9.80665 / self.parameters.walk_com_height)
+
+    def assertTrajectoriesEqual(self, a, b, epsilon=1e-6):
+        self.assertAlmostEqual(a.t_start, b.t_start)
+        self.assertAlmostEqual(a.t_end, b.t_end)
+
+        for t in np.linspace(a.t_start, a.t_end, 100):
+            self.assertNumpyEqual(a.get_p_world_CoM(t), b.get_p_world_CoM(t), epsilon=epsilon)
+            self.assertNumpyEqual(a.get_p_world_ZMP(t, self.omega()), b.get_p_world_ZMP(t, self.omega()), epsilon=epsilon)
+            self.assertNumpyEqual(a.get_T_world_left(t), b.get_T_world_left(t), epsilon=epsilon)
+            self.assertNumpyEqual(a.get_T_world_right(t), b.get_T_world_right(t), epsilon=epsilon)
+
+    def test_replan(self):
+        """
+        Replanning several times with the same generator gives the same trajectories as a fresh generator, whether
+        the CoM problem kept by the thread is reused or rebuilt
+        """
+        wpg = placo.WalkPatternGenerator(self.robot, self.parameters)
+        trajectory = wpg.plan(self.make_supports(), self.initial_com(), 0.0)
+
+        replans = 0
+        t = 0.0
+        while replans < 5 and t < trajectory.t_end:
+            t += self.parameters.dt()
+            if not wpg.can_replan_supports(trajectory, t):
+                continue
+
+            supports = wpg.replan_supports(self.planner, trajectory, t)
+            fresh_trajectory = placo.WalkPatternGenerator(self.robot, self.parameters).replan(supports, trajectory, t)
+
+            # Planning with another horizon in between, so that the CoM problem is rebuilt
+            self.parameters.planned_timesteps += 10
+            placo.WalkPatternGenerator(self.robot, self.parameters).plan(self.make_supports(), self.initial_com(), 0.0)
+            self.parameters.planned_timesteps -= 10
+            rebuilt_trajectory = placo.WalkPatternGenerator(self.robot, self.parameters).replan(supports, trajectory, t)
+
+            trajectory = wpg.replan(supports, trajectory, t)
+            self.assertTrajectoriesEqual(trajectory, fresh_trajectory)
+            self.assertTrajectoriesEqual(trajectory, rebuilt_trajectory)
+
+            replans += 1
+            t += self.parameters.single_support_duration
+
+        self.assertEqual(replans, 5)
+
+    def test_dcm_planner(self):
+        """
+        The DCM planner keeps the ZMP in the support polygons, and ends close to the jerk planner
+        """
+        self.parameters.planned_timesteps = 500
+        supports = self.make_supports()
+        jerk_trajectory = placo.WalkPatternGenerator(self.robot, self.parameters).plan(supports, self.initial_com(), 0.0)
+
+        self.parameters.com_planner = placo.CoMPlanner.dcm_planner
+        trajectory = placo.WalkPatternGenerator(self.robot, self.parameters).plan(supports, self.initial_com(), 0.0)
+
+        for t in np.linspace(trajectory.t_start, trajectory.t_end, 500):
+            zmp = trajectory.get_p_world_ZMP(t, self.omega())
+            polygon = trajectory.get_support(t).support_polygon()
+            self.assertGreater(polygon_distance(polygon, zmp), self.parameters.zmp_margin - 2e-3, msg=f"ZMP at t={t}")
+
+        self.assertNumpyEqual(
+            trajectory.get_p_world_CoM(trajectory.t_end), jerk_trajectory.get_p_world_CoM(jerk_trajectory.t_end), epsilon=1e-2
+        )
+
+    def test_part_boundaries(self):
+        """
+        Parts are found consistently at their boundaries, whatever the order of the queries
+        """
+        trajectory = placo.WalkPatternGenerator(self.robot, self.parameters).plan(
+            self.make_supports(), self.initial_com(), 0.0
+        )
+
+        starts = sorted(set(trajectory.get_part_t_start(t) for t in np.linspace(0.0, trajectory.t_end, 1000)))
+        self.assertGreater(len(starts), 2)
+
+        # A boundary belongs to the part starting at it
+        ts = []
+        expected = []
+        for k, start in enumerate(starts):
+            ts += [start, start + 1e-6]
+            expected += [start, start]
+            if k > 0:
+                ts.append(start - 1e-6)
+                expected.append(starts[k - 1])
+        ts += [-1.0, trajectory.t_end, trajectory.t_end + 1.0]
+        expected += [starts[0], starts[-1], starts[-1]]
+
+        np.random.seed(0)
+        for order in [np.argsort(ts), np.argsort(ts)[::-1], np.random.permutation(len(ts))]:
+            for index in order:
+                self.assertAlmostEqual(trajectory.get_part_t_start(ts[index]), expected[index], msg=f"t={ts[index]}")
+
+    def test_sample_grid(self):
+        """
+        Sampling the trajectory on a grid gives the same values as the per-time getters
+        """
+        trajectory = placo.WalkPatternGenerator(self.robot, self.parameters).plan(
+            self.make_supports(), self.initial_com(), 0.0
+        )
+        samples = trajectory.sample_grid(0.0, trajectory.t_end, 0.01)
+
+        self.assertAlmostEqual(samples.ts[0], 0.0)
+        self.assertLessEqual(samples.ts[-1], trajectory.t_end + 1e-9)
+        self.assertGreater(samples.ts[-1], trajectory.t_end - 0.01)
+
+        yaw = lambda R: np.arctan2(R[1, 0], R[0, 0])
+        for k, t in enumerate(samples.ts):
+            self.assertNumpyEqual(samples.com_pos[k], trajectory.get_p_world_CoM(t))
+            self.assertNumpyEqual(samples.com_vel[k], trajectory.get_v_world_CoM(t))
+            self.assertNumpyEqual(samples.com_acc[k], trajectory.get_a_world_CoM(t))
+            self.assertNumpyEqual(samples.zmp[k], trajectory.get_p_world_ZMP(t, self.omega()))
+            self.assertNumpyEqual(samples.dcm[k], trajectory.get_p_world_DCM(t, self.omega()))
+
+            T_world_left = trajectory.get_T_world_left(t)
+            T_world_right = trajectory.get_T_world_right(t)
+            self.assertNumpyEqual(samples.left_pos[k], T_world_left[:3, 3])
+            self.assertNumpyEqual(samples.right_pos[k], T_world_right[:3, 3])
+            self.assertAlmostEqual(samples.left_yaw[k], yaw(T_world_left))
+            self.assertAlmostEqual(samples.right_yaw[k], yaw(T_world_right))
+            self.assertAlmostEqual(samples.trunk_yaw[k], yaw(trajectory.get_R_world_trunk(t)))
+
+            self.assertEqual(samples.support_side[k], int(trajectory.support_side(t)))
+            self.assertEqual(bool(samples.support_is_both[k]), trajectory.support_is_both(t))
+
+    def test_plan_batch(self):
+        """
+        Planning a batch with several threads gives the same results as serial plans, in the order of the jobs
+        """
+        jobs = []
+        for k in range(8):
+            self.planner.configure(0.01 * k, 0.005 * (k % 3), 0.05 * (k % 2), 4 + k % 3)
+
+            job = placo.WalkPlanJob()
+            job.supports = self.make_supports(0.1 * k)
+            job.parameters = self.parameters
+            job.initial_com_world = self.initial_com(0.1 * k)
+            job.t_start = 0.5 * k
+            jobs.append(job)
+
+        wpg = placo.WalkPatternGenerator(self.robot, self.parameters)
+        results = wpg.plan_batch(jobs, 4)
+        self.assertEqual(len(results), len(jobs))
+
+        for job, result in zip(jobs, results):
+            self.assertTrue(result.success, msg=result.error)
+            parameters = job.parameters
+            trajectory = placo.WalkPatternGenerator(self.robot, parameters).plan(
+                job.supports, job.initial_com_world, job.t_start
+            )
+            self.assertTrajectoriesEqual(result.trajectory, trajectory)
+            self.assertAlmostEqual(result.duration, trajectory.t_end - trajectory.t_start)
+
+        # Default arguments (one thread per core, trajectories kept) give the same metrics
+        for result, default_result in zip(results, wpg.plan_batch(jobs)):
+            self.assertTrajectoriesEqual(default_result.trajectory, result.trajectory)
+            self.assertAlmostEqual(default_result.min_zmp_margin, result.min_zmp_margin)
+            self.assertAlmostEqual(default_result.max_com_vel, result.max_com_vel)
+            self.assertAlmostEqual(default_result.max_com_acc, result.max_com_acc)
+
+        for result, light_result in zip(results, wpg.plan_batch(jobs, keep_trajectories=False)):
+            self.assertAlmostEqual(light_result.min_zmp_margin, result.min_zmp_margin)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -10,7 +10,8 @@ void AvoidSelfCollisionsConstraint::add_constraint(problem::Problem& problem, pr
     throw std::runtime_error("AvoidSelfCollisionsConstraint::add_constraint: dt is not set");
   }
 
-  std::vector<model::RobotWrapper::Distance> distances = solver->robot.distances();
+  // Pairs farther than the trigger distance are culled by the broad phase
+  solver->robot.distances(distances, self_collisions_trigger);
 
   int constraints = 0;
 
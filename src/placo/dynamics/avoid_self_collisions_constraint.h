@@ -2,6 +2,7 @@
 
 #include "placo/problem/problem.h"
 #include "placo/dynamics/constraint.h"
+#include "placo/model/robot_wrapper.h"
 
 namespace placo::dynamics
 {
@@ -20,5 +21,11 @@ public:
   double self_collisions_trigger = 0.01;
 
   virtual void add_constraint(problem::Problem& problem, problem::Expression& tau) override;
+
+protected:
+  /**
+   * @brief Distances buffer, reused from one solve to the next to avoid allocations
+   */
+  std::vector<model::RobotWrapper::Distance> distances;
 };
 }  // namespace placo::dynamics
\ No newline at end of file
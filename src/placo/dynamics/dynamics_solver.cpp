@@ -11,6 +11,8 @@ void DynamicsSolver::set_passive(const std::string& joint_name, double kp, doubl
   oj.passive = true;
   oj.kp = kp;
   oj.kd = kd;
+  oj.q_offset = robot.get_joint_offset(joint_name);
+  oj.v_offset = robot.get_joint_v_offset(joint_name);
   override_joints[joint_name] = oj;
 }
 
@@ -18,6 +20,8 @@ void DynamicsSolver::set_tau(const std::string& joint_name, double tau)
 {
   OverrideJoint oj;
   oj.tau = tau;
+  oj.q_offset = robot.get_joint_offset(joint_name);
+  oj.v_offset = robot.get_joint_v_offset(joint_name);
   override_joints[joint_name] = oj;
 }
 
@@ -414,12 +418,10 @@ DynamicsSolver::Result DynamicsSolver::solve(bool integrate)
   int k = 0;
   for (auto& entry : override_joints)
   {
-    std::string joint = entry.first;
-    OverrideJoint oj = entry.second;
-    double q = robot.get_joint(joint);
-    double qd = robot.get_joint_velocity(joint);
-    int index = robot.get_joint_v_offset(joint);
-    override_indices.push_back(index);
+    const OverrideJoint& oj = entry.second;
+    double q = robot.state.q[oj.q_offset];
+    double qd = robot.state.qd[oj.v_offset];
+    override_indices.push_back(oj.v_offset);
 
     if (oj.tau)
     {
@@ -54,6 +54,10 @@ public:
 
     // Else, a custom tau will be used
     double tau;
+
+    // Offsets of the joint in q and qd, resolved when the joint is overriden
+    int q_offset;
+    int v_offset;
   };
 
   DynamicsSolver(model::RobotWrapper& robot);
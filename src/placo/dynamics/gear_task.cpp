@@ -10,6 +10,7 @@ GearTask::GearTask()
 void GearTask::set_gear(std::string target, std::string source, double ratio)
 {
   gears.clear();
+  q_offsets.clear();
   add_gear(target, source, ratio);
 }
 
@@ -17,6 +18,8 @@ void GearTask::add_gear(std::string target, std::string source, double ratio)
 {
   int target_id = solver->robot.get_joint_v_offset(target);
   int source_id = solver->robot.get_joint_v_offset(source);
+  q_offsets[target_id] = solver->robot.get_joint_offset(target);
+  q_offsets[source_id] = solver->robot.get_joint_offset(source);
 
   gears[target_id][source_id] = ratio;
 }
@@ -37,7 +40,7 @@ void GearTask::update()
     double desired_q = 0;
     double desired_qd = 0;
 
-    double q_target = solver->robot.state.q[target + 1];
+    double q_target = solver->robot.state.q[q_offsets[target]];
     double qd_target = solver->robot.state.qd[target];
     A(k, target) = -1;
 
@@ -46,7 +49,7 @@ void GearTask::update()
       int source = gear.first;
       double ratio = gear.second;
 
-      desired_q += solver->robot.state.q[source + 1] * ratio;
+      desired_q += solver->robot.state.q[q_offsets[source]] * ratio;
       desired_qd += solver->robot.state.qd[source] * ratio;
       A(k, source) = ratio;
     }
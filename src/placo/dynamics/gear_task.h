@@ -41,5 +41,11 @@ public:
   void update() override;
   std::string type_name() override;
   std::string error_unit() override;
+
+protected:
+  /**
+   * @brief Offsets in q of the joints involved in \ref gears, indexed by their offsets in qd
+   */
+  std::map<int, int> q_offsets;
 };
 }  // namespace placo::dynamics
\ No newline at end of file
@@ -25,14 +25,25 @@ void JointsTask::update()
   int k = 0;
   for (auto& entry : joints)
   {
-    double q = solver->robot.get_joint(entry.first);
-    double dq = solver->robot.state.qd[solver->robot.get_joint_v_offset(entry.first)];
+    // The offsets are keyed by name, since joints can also be added to or removed from the map directly (e.g from
+    // Python)
+    auto offset = offsets.find(entry.first);
+    if (offset == offsets.end())
+    {
+      offset = offsets
+                   .emplace(entry.first, std::make_pair(solver->robot.get_joint_offset(entry.first),
+                                                        solver->robot.get_joint_v_offset(entry.first)))
+                   .first;
+    }
+
+    double q = solver->robot.state.q[offset->second.first];
+    double dq = solver->robot.state.qd[offset->second.second];
     double target_dq = djoints.count(entry.first) ? djoints[entry.first] : 0;
     double target_ddq = ddjoints.count(entry.first) ? ddjoints[entry.first] : 0;
 
     double desired_ddq = kp * (entry.second - q) + get_kd() * (target_dq - dq) + target_ddq;
 
-    A(k, solver->robot.get_joint_v_offset(entry.first)) = 1;
+    A(k, offset->second.second) = 1;
     b(k, 0) = desired_ddq;
     error(k, 0) = entry.second - q;
     derror(k, 0) = target_dq - dq;
@@ -2,6 +2,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "placo/dynamics/task.h"
 #include "placo/model/robot_wrapper.h"
 #include "placo/tools/axises_mask.h"
@@ -43,5 +44,11 @@ public:
   void update() override;
   std::string type_name() override;
   std::string error_unit() override;
+
+protected:
+  /**
+   * @brief Offsets of the joints in q and qd, keyed by joint name and resolved the first time a joint is used
+   */
+  std::map<std::string, std::pair<int, int>> offsets;
 };
 }  // namespace placo::dynamics
\ No newline at end of file
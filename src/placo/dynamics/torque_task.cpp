@@ -27,7 +27,14 @@ void TorqueTask::update()
   int k = 0;
   for (auto& entry : torques)
   {
-    A(k, solver->robot.get_joint_v_offset(entry.first)) = 1;
+    // The offsets are keyed by name, so that they stay valid whatever the changes to the map
+    auto offset = offsets.find(entry.first);
+    if (offset == offsets.end())
+    {
+      offset = offsets.emplace(entry.first, solver->robot.get_joint_v_offset(entry.first)).first;
+    }
+
+    A(k, offset->second) = 1;
     b(k, 0) = entry.second;
     k++;
   }
@@ -1,12 +1,5 @@
 #include "placo/humanoid/footsteps_planner.h"
 #include "placo/tools/utils.h"
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/adapted/boost_tuple.hpp>
-#include <boost/geometry/geometries/polygon.hpp>
-
-BOOST_GEOMETRY_REGISTER_BOOST_TUPLE_CS(cs::cartesian)
-typedef boost::tuple<double, double> b_point;
-typedef boost::geometry::model::polygon<b_point> b_polygon;
 
 namespace placo::humanoid
 {
@@ -18,22 +11,21 @@ FootstepsPlanner::Footstep::Footstep(double foot_width, double foot_length)
 
 std::vector<Eigen::Vector2d> FootstepsPlanner::Footstep::compute_polygon(double margin)
 {
-  std::vector<Eigen::Vector2d> polygon;
+  return compute_polygon2d(margin).to_vector();
+}
+
+tools::Polygon2d FootstepsPlanner::Footstep::compute_polygon2d(double margin)
+{
+  tools::Polygon2d polygon;
 
   // Making a clockwise polygon
-  std::vector<std::pair<double, double>> contour = {
-    std::make_pair(-1., 1.),
-    std::make_pair(1., 1.),
-    std::make_pair(1., -1.),
-    std::make_pair(-1., -1.),
-  };
-
-  for (auto sxsy : contour)
+  const double contour[4][2] = { { -1., 1. }, { 1., 1. }, { 1., -1. }, { -1., -1. } };
+
+  for (auto& sxsy : contour)
   {
     Eigen::Vector3d corner =
-        frame * Eigen::Vector3d(sxsy.first * (margin + foot_length / 2), sxsy.second * (margin + foot_width / 2), 0.);
-    Eigen::Vector2d point(corner.x(), corner.y());
-    polygon.push_back(point);
+        frame * Eigen::Vector3d(sxsy[0] * (margin + foot_length / 2), sxsy[1] * (margin + foot_width / 2), 0.);
+    polygon.push_back(corner.x(), corner.y());
   }
 
   return polygon;
@@ -72,54 +64,81 @@ bool FootstepsPlanner::Footstep::polygon_contains(std::vector<Eigen::Vector2d>&
 
 bool FootstepsPlanner::Footstep::overlap(Footstep& other, double margin)
 {
-  std::vector<Eigen::Vector2d> support1 = compute_polygon(margin);
-  std::vector<Eigen::Vector2d> support2 = other.compute_polygon(margin);
+  return compute_polygon2d(margin).overlap(other.compute_polygon2d(margin));
+}
 
-  for (auto pt : support1)
+std::vector<Eigen::Vector2d> FootstepsPlanner::Support::support_polygon()
+{
+  return support_polygon2d().to_vector();
+}
+
+const tools::Polygon2d& FootstepsPlanner::Support::support_polygon2d()
+{
+  if (!computed_polygon)
   {
-    if (polygon_contains(support2, pt))
+    tools::Polygon2d points;
+    for (auto& footstep : footsteps)
     {
-      return true;
+      tools::Polygon2d footstep_polygon = footstep.compute_polygon2d();
+      for (int k = 0; k < footstep_polygon.size(); k++)
+      {
+        points.push_back(footstep_polygon.point(k).x(), footstep_polygon.point(k).y());
+      }
     }
+
+    polygon = points.convex_hull();
+    computed_polygon = true;
   }
-  for (auto pt : support2)
+
+  return polygon;
+}
+
+static bool same_footsteps(const FootstepsPlanner::Support& a, const FootstepsPlanner::Support& b)
+{
+  if (a.footsteps.size() != b.footsteps.size())
+  {
+    return false;
+  }
+
+  // Frames are compared exactly, since the footsteps kept by a replan are copies
+  for (size_t k = 0; k < a.footsteps.size(); k++)
   {
-    if (polygon_contains(support1, pt))
+    const FootstepsPlanner::Footstep& fa = a.footsteps[k];
+    const FootstepsPlanner::Footstep& fb = b.footsteps[k];
+
+    if (fa.side != fb.side || fa.foot_width != fb.foot_width || fa.foot_length != fb.foot_length ||
+        fa.frame.matrix() != fb.frame.matrix())
     {
-      return true;
+      return false;
     }
   }
 
-  return false;
+  return true;
 }
 
-std::vector<Eigen::Vector2d> FootstepsPlanner::Support::support_polygon()
+void FootstepsPlanner::reuse_polygons(std::vector<Support>& supports, const std::vector<Support>& previous)
 {
-  if (!computed_polygon)
-  {
-    polygon.clear();
+  // Supports being in chronological order, the search starts after the last previous support reused
+  size_t start = 0;
 
-    b_polygon poly, hull;
-    for (auto& footstep : footsteps)
+  for (auto& support : supports)
+  {
+    if (support.computed_polygon)
     {
-      for (auto& pt : footstep.support_polygon())
-      {
-        boost::geometry::append(poly, b_point(pt.x(), pt.y()));
-      }
+      continue;
     }
 
-    // Boost convex hull is also clockwise
-    boost::geometry::convex_hull(poly, hull);
-
-    for (auto& pt : hull.outer())
+    for (size_t k = start; k < previous.size(); k++)
     {
-      polygon.push_back(Eigen::Vector2d(pt.get<0>(), pt.get<1>()));
+      if (previous[k].computed_polygon && same_footsteps(support, previous[k]))
+      {
+        support.polygon = previous[k].polygon;
+        support.computed_polygon = true;
+        start = k + 1;
+        break;
+      }
     }
-    polygon.pop_back();
-    computed_polygon = true;
   }
-
-  return polygon;
 }
 
 bool FootstepsPlanner::Support::kick()
@@ -357,9 +376,35 @@ std::vector<FootstepsPlanner::Footstep> FootstepsPlanner::plan(HumanoidRobot::Si
   T_world_current_frame = (current_side == HumanoidRobot::Side::Left) ? T_world_left : T_world_right;
   footsteps.push_back(create_footstep(current_side, T_world_current_frame));
 
+  if (incremental)
+  {
+    // Looking for the initial footsteps in the previous plan, the committed steps that follow them are kept
+    for (int k = 0; k + 1 < (int)last_plan.size(); k++)
+    {
+      if (last_plan[k] == footsteps[0] && last_plan[k + 1] == footsteps[1])
+      {
+        int end = std::min<int>(k + 2 + committed_steps, last_plan.size() - 1);
+        for (int i = k + 2; i < end; i++)
+        {
+          footsteps.push_back(last_plan[i]);
+        }
+        break;
+      }
+    }
+
+    // The remaining footsteps are planned from the last two ones
+    Footstep& flying = footsteps[footsteps.size() - 2];
+    Footstep& support = footsteps[footsteps.size() - 1];
+    flying_side = flying.side;
+    T_world_left = (flying.side == HumanoidRobot::Left) ? flying.frame : support.frame;
+    T_world_right = (flying.side == HumanoidRobot::Right) ? flying.frame : support.frame;
+  }
+
   // Calling specific implementation
   plan_impl(footsteps, flying_side, T_world_left, T_world_right);
 
+  last_plan = footsteps;
+
   return footsteps;
 }
 }  // namespace placo::humanoid
\ No newline at end of file
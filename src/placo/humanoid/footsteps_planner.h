@@ -5,6 +5,7 @@
 #include <vector>
 #include "placo/humanoid/humanoid_robot.h"
 #include "placo/humanoid/humanoid_parameters.h"
+#include "placo/tools/polygon_2d.h"
 
 namespace placo::humanoid
 {
@@ -30,6 +31,11 @@ public:
     std::vector<Eigen::Vector2d> support_polygon();
     std::vector<Eigen::Vector2d> compute_polygon(double margin = 0.);
 
+    /**
+     * @brief Same as compute_polygon(), but without allocation
+     */
+    tools::Polygon2d compute_polygon2d(double margin = 0.);
+
     bool overlap(Footstep& other, double margin = 0.);
 
     static bool polygon_contains(std::vector<Eigen::Vector2d>& polygon, Eigen::Vector2d point);
@@ -42,7 +48,7 @@ public:
   struct Support
   {
     std::vector<Footstep> footsteps;
-    std::vector<Eigen::Vector2d> polygon;
+    tools::Polygon2d polygon;
     bool computed_polygon = false;
     bool start = false;
     bool end = false;
@@ -50,6 +56,11 @@ public:
     bool kick();
     std::vector<Eigen::Vector2d> support_polygon();
 
+    /**
+     * @brief The support polygon (convex hull of the footsteps polygons), computed once
+     */
+    const tools::Polygon2d& support_polygon2d();
+
     /**
      * @brief Returns the frame for the support. It will be the (interpolated)
      * average of footsteps frames
@@ -97,6 +108,17 @@ public:
   std::vector<Footstep> plan(HumanoidRobot::Side flying_side, Eigen::Affine3d T_world_left,
                              Eigen::Affine3d T_world_right);
 
+  /**
+   * @brief If true, plan() keeps the first \ref committed_steps of the previous plan when the initial
+   * footsteps are part of it, and only plans the remaining footsteps
+   */
+  bool incremental = false;
+
+  /**
+   * @brief Number of footsteps (after the initial ones) kept from the previous plan in incremental mode
+   */
+  int committed_steps = 1;
+
   /**
    * @brief Generate the supports from the footsteps
    * @param start should we add a double support at the begining of the move?
@@ -108,6 +130,14 @@ public:
   static std::vector<Support> make_supports(std::vector<Footstep> footsteps, bool start = true, bool middle = false,
                                             bool end = true);
 
+  /**
+   * @brief Reuses the support polygons (convex hulls) already computed in previous supports, for the supports having
+   * the same footsteps frames. Both are expected in chronological order (e.g. the supports of a replanned trajectory)
+   * @param supports supports to update
+   * @param previous supports whose polygons can be reused
+   */
+  static void reuse_polygons(std::vector<Support>& supports, const std::vector<Support>& previous);
+
   /**
    * @brief Return the type of footsteps planner
    */
@@ -132,6 +162,11 @@ public:
   HumanoidParameters& parameters;
 
 protected:
+  /**
+   * @brief Footsteps produced by the last call to plan()
+   */
+  std::vector<Footstep> last_plan;
+
   virtual void plan_impl(std::vector<Footstep>&, HumanoidRobot::Side flying_side, Eigen::Affine3d T_world_left,
                          Eigen::Affine3d T_world_right) = 0;
 };
@@ -16,11 +16,12 @@ void FootstepsPlannerRepetitive::plan_impl(std::vector<FootstepsPlanner::Footste
                                            HumanoidRobot::Side flying_side, Eigen::Affine3d T_world_left,
                                            Eigen::Affine3d T_world_right)
 {
-  Footstep footstep = footsteps[1];
+  Footstep footstep = footsteps.back();
 
   if (nb_steps > 0)
   {
-    for (int steps = 0; steps < nb_steps - 1; steps += 1)
+    // In incremental mode, the footsteps kept from the previous plan are part of the nb_steps
+    for (int steps = footsteps.size() - 2; steps < nb_steps - 1; steps += 1)
     {
       footstep = clipped_opposite_footstep(footstep, d_x, d_y, d_theta);
       footsteps.push_back(footstep);
@@ -0,0 +1,376 @@
+#include "placo/humanoid/footsteps_planner_search.h"
+#include "placo/tools/utils.h"
+#include <chrono>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+namespace placo::humanoid
+{
+FootstepsPlannerSearch::FootstepsPlannerSearch(HumanoidParameters& parameters) : FootstepsPlanner(parameters)
+{
+}
+
+std::string FootstepsPlannerSearch::name()
+{
+  return "search";
+}
+
+void FootstepsPlannerSearch::configure(Eigen::Affine3d T_world_left_target, Eigen::Affine3d T_world_right_target)
+{
+  T_world_targetLeft = T_world_left_target;
+  T_world_targetRight = T_world_right_target;
+}
+
+void FootstepsPlannerSearch::set_cost_map(Eigen::MatrixXd cost_map_, Eigen::Vector2d origin, double resolution)
+{
+  if (resolution <= 0)
+  {
+    throw std::runtime_error("FootstepsPlannerSearch: the cost map resolution should be positive");
+  }
+
+  cost_map = cost_map_;
+  cost_map_origin = origin;
+  cost_map_resolution = resolution;
+}
+
+void FootstepsPlannerSearch::clear_cost_map()
+{
+  cost_map.resize(0, 0);
+  cost_map_resolution = 0.;
+}
+
+double FootstepsPlannerSearch::map_cost(Eigen::Vector2d position)
+{
+  if (cost_map_resolution <= 0)
+  {
+    return 0.;
+  }
+
+  Eigen::Vector2d cell = (position - cost_map_origin) / cost_map_resolution;
+
+  return cell_cost(std::floor(cell.x()), std::floor(cell.y()));
+}
+
+double FootstepsPlannerSearch::cell_cost(int i, int j)
+{
+  if (i < 0 || j < 0 || i >= cost_map.rows() || j >= cost_map.cols())
+  {
+    return outside_cost;
+  }
+
+  return cost_map(i, j);
+}
+
+uint64_t FootstepsPlannerSearch::footstep_key(const Footstep& footstep)
+{
+  // 20 bits per coordinate, one bit for the side and one bit for the goal (so that a goal footstep is never
+  // replaced by a non-goal footstep of the same cell)
+  auto quantize = [](double value, double resolution) -> uint64_t {
+    return ((int64_t)std::round(value / resolution) + (1 << 19)) & ((1 << 20) - 1);
+  };
+
+  uint64_t key = is_goal(footstep) ? 1 : 0;
+  key = (key << 1) | ((footstep.side == HumanoidRobot::Side::Left) ? 1 : 0);
+  key = (key << 20) | quantize(footstep.frame.translation().x(), discretization_xy);
+  key = (key << 20) | quantize(footstep.frame.translation().y(), discretization_xy);
+  key = (key << 20) | quantize(tools::frame_yaw(footstep.frame.rotation()), discretization_yaw);
+
+  return key;
+}
+
+double FootstepsPlannerSearch::footstep_cost(Footstep& footstep)
+{
+  if (cost_map_resolution <= 0)
+  {
+    return step_cost;
+  }
+
+  // Range of the cells covered by the bounding box of the foot
+  tools::Polygon2d polygon = footstep.compute_polygon2d();
+  Eigen::Vector2d min = polygon.point(0);
+  Eigen::Vector2d max = polygon.point(0);
+  for (int k = 1; k < polygon.size(); k++)
+  {
+    min = min.cwiseMin(polygon.point(k));
+    max = max.cwiseMax(polygon.point(k));
+  }
+  Eigen::Vector2i min_cell = ((min - cost_map_origin) / cost_map_resolution).array().floor().cast<int>();
+  Eigen::Vector2i max_cell = ((max - cost_map_origin) / cost_map_resolution).array().floor().cast<int>();
+
+  // The cost of the footstep is the maximum cost of the cells overlapped by the foot
+  double cost = 0.;
+  tools::Polygon2d cell;
+  for (int i = min_cell.x(); i <= max_cell.x(); i++)
+  {
+    for (int j = min_cell.y(); j <= max_cell.y(); j++)
+    {
+      double value = cell_cost(i, j);
+      if (value <= cost)
+      {
+        continue;
+      }
+
+      Eigen::Vector2d corner = cost_map_origin + Eigen::Vector2d(i, j) * cost_map_resolution;
+      cell.clear();
+      cell.push_back(corner.x(), corner.y() + cost_map_resolution);
+      cell.push_back(corner.x() + cost_map_resolution, corner.y() + cost_map_resolution);
+      cell.push_back(corner.x() + cost_map_resolution, corner.y());
+      cell.push_back(corner.x(), corner.y());
+
+      if (!polygon.overlap(cell))
+      {
+        continue;
+      }
+
+      if (value >= obstacle_threshold)
+      {
+        return -1.;
+      }
+      cost = value;
+    }
+  }
+
+  return step_cost + cost_weight * cost;
+}
+
+bool FootstepsPlannerSearch::reachable(Footstep& from, const Footstep& to)
+{
+  // Step from the neutral opposite footstep, before the walk_dtheta_spacing offset applied by
+  // clipped_opposite_footstep()
+  Eigen::Affine3d T_neutral_to = parameters.opposite_frame(from.side, from.frame).inverse() * to.frame;
+  double d_theta = tools::frame_yaw(T_neutral_to.rotation());
+  double spacing = parameters.walk_dtheta_spacing * fabs(d_theta);
+  double d_y = T_neutral_to.translation().y() + ((from.side == HumanoidRobot::Side::Left) ? spacing : -spacing);
+
+  Footstep footstep = clipped_opposite_footstep(from, T_neutral_to.translation().x(), d_y, d_theta);
+  double yaw_error =
+      fabs(tools::wrap_angle(tools::frame_yaw(footstep.frame.rotation()) - tools::frame_yaw(to.frame.rotation())));
+
+  return (footstep.frame.translation() - to.frame.translation()).head(2).norm() < 1e-6 && yaw_error < 1e-6;
+}
+
+double FootstepsPlannerSearch::heuristic(const Footstep& footstep)
+{
+  Eigen::Affine3d T_world_target =
+      (footstep.side == HumanoidRobot::Side::Left) ? T_world_targetLeft : T_world_targetRight;
+
+  // Estimation of the number of steps, a foot moving up to twice the maximum step every two steps. It can overestimate
+  // (e.g. when the other foot reaches its target first), favoring fast searches over optimality
+  double distance = (T_world_target.translation() - footstep.frame.translation()).head(2).norm();
+  double yaw_error = fabs(tools::wrap_angle(tools::frame_yaw(T_world_target.rotation()) -
+                                            tools::frame_yaw(footstep.frame.rotation())));
+  double step_length = std::max(parameters.walk_max_dx_forward, parameters.walk_max_dy);
+
+  return step_cost * std::max(distance / step_length, yaw_error / parameters.walk_max_dtheta);
+}
+
+bool FootstepsPlannerSearch::is_goal(const Footstep& footstep)
+{
+  Eigen::Affine3d T_world_target =
+      (footstep.side == HumanoidRobot::Side::Left) ? T_world_targetLeft : T_world_targetRight;
+
+  double distance = (T_world_target.translation() - footstep.frame.translation()).head(2).norm();
+  double yaw_error = fabs(tools::wrap_angle(tools::frame_yaw(T_world_target.rotation()) -
+                                            tools::frame_yaw(footstep.frame.rotation())));
+
+  return distance <= goal_tolerance && yaw_error <= goal_yaw_tolerance;
+}
+
+void FootstepsPlannerSearch::plan_impl(std::vector<FootstepsPlanner::Footstep>& footsteps,
+                                       HumanoidRobot::Side flying_side, Eigen::Affine3d T_world_left,
+                                       Eigen::Affine3d T_world_right)
+{
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Discrete set of steps, expressed as offsets from the neutral opposite footstep
+  auto sample = [](double min, double max, int n, int k) { return (n > 1) ? min + (max - min) * k / (n - 1) : 0.; };
+  std::vector<Eigen::Vector3d> actions;
+  for (int ix = 0; ix < actions_x; ix++)
+  {
+    for (int iy = 0; iy < actions_y; iy++)
+    {
+      for (int iyaw = 0; iyaw < actions_yaw; iyaw++)
+      {
+        actions.push_back(Eigen::Vector3d(
+            sample(-parameters.walk_max_dx_backward, parameters.walk_max_dx_forward, actions_x, ix),
+            sample(-parameters.walk_max_dy, parameters.walk_max_dy, actions_y, iy),
+            sample(-parameters.walk_max_dtheta, parameters.walk_max_dtheta, actions_yaw, iyaw)));
+      }
+    }
+  }
+
+  // Nodes of the search, the hashed map gives the node associated with a discretized footstep
+  std::vector<Node> nodes;
+  std::unordered_map<uint64_t, int> node_index;
+
+  // Open list (lazy deletion: outdated entries are skipped when popped), and closed nodes whose cost was improved
+  typedef std::pair<double, int> OpenEntry;
+  std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+  std::vector<int> inconsistent;
+
+  double epsilon = std::max(1., initial_epsilon);
+  auto f = [&](int id) { return nodes[id].g + epsilon * nodes[id].h; };
+
+  Footstep start = footsteps.back();
+  nodes.push_back(Node{ start, 0., heuristic(start), -1, 0, false });
+  node_index[footstep_key(start)] = 0;
+  open.push(OpenEntry(f(0), 0));
+
+  int best_goal = is_goal(start) ? 0 : -1;
+  int closest = 0;
+  bool interrupted = false;
+  expansions = 0;
+  solution_epsilon = 0.;
+
+  while (best_goal != 0)
+  {
+    // Improving the path with the current epsilon
+    while (!open.empty())
+    {
+      OpenEntry entry = open.top();
+      int id = entry.second;
+
+      if (nodes[id].closed || entry.first > f(id) + 1e-9)
+      {
+        open.pop();
+        continue;
+      }
+
+      if (best_goal >= 0 && nodes[best_goal].g <= entry.first)
+      {
+        break;
+      }
+
+      double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+      if (elapsed > max_time || expansions >= max_expansions)
+      {
+        interrupted = true;
+        break;
+      }
+
+      open.pop();
+      nodes[id].closed = true;
+      expansions += 1;
+
+      if (nodes[id].depth >= max_steps)
+      {
+        continue;
+      }
+
+      // The step directly reaching the target is added to the discrete set
+      Footstep footstep = nodes[id].footstep;
+      Eigen::Affine3d T_neutral_target =
+          parameters.opposite_frame(footstep.side, footstep.frame).inverse() *
+          ((footstep.side == HumanoidRobot::Side::Left) ? T_world_targetRight : T_world_targetLeft);
+      actions.push_back(Eigen::Vector3d(T_neutral_target.translation().x(), T_neutral_target.translation().y(),
+                                        tools::frame_yaw(T_neutral_target.rotation())));
+
+      for (auto& action : actions)
+      {
+        Footstep new_footstep = clipped_opposite_footstep(footstep, action.x(), action.y(), action.z());
+        double cost = footstep_cost(new_footstep);
+        if (cost < 0)
+        {
+          continue;
+        }
+
+        double g = nodes[id].g + cost;
+        uint64_t key = footstep_key(new_footstep);
+        auto it = node_index.find(key);
+        int new_id;
+
+        if (it == node_index.end())
+        {
+          new_id = nodes.size();
+          nodes.push_back(Node{ new_footstep, g, heuristic(new_footstep), id, nodes[id].depth + 1, false });
+          node_index[key] = new_id;
+
+          if (nodes[new_id].h < nodes[closest].h)
+          {
+            closest = new_id;
+          }
+        }
+        else
+        {
+          // The footstep stored in the node is kept, since its children were generated from it. The improvement is
+          // only accepted if this footstep can also be reached from the new parent
+          new_id = it->second;
+          g = nodes[id].g + footstep_cost(nodes[new_id].footstep);
+
+          if (g >= nodes[new_id].g - 1e-9 || !reachable(footstep, nodes[new_id].footstep))
+          {
+            continue;
+          }
+
+          nodes[new_id].g = g;
+          nodes[new_id].parent = id;
+          nodes[new_id].depth = nodes[id].depth + 1;
+        }
+
+        // Goals are not expanded
+        if (is_goal(nodes[new_id].footstep))
+        {
+          if (best_goal < 0 || g < nodes[best_goal].g)
+          {
+            best_goal = new_id;
+          }
+        }
+        else if (nodes[new_id].closed)
+        {
+          inconsistent.push_back(new_id);
+        }
+        else
+        {
+          open.push(OpenEntry(f(new_id), new_id));
+        }
+      }
+
+      actions.pop_back();
+    }
+
+    if (interrupted)
+    {
+      break;
+    }
+
+    if (best_goal >= 0)
+    {
+      solution_epsilon = epsilon;
+    }
+
+    if (epsilon <= 1. || epsilon_decrease <= 0. || (open.empty() && inconsistent.empty()))
+    {
+      break;
+    }
+
+    // Decreasing epsilon, the open list is rebuilt with the inconsistent nodes and the closed set is cleared
+    epsilon = std::max(1., epsilon - epsilon_decrease);
+    while (!open.empty())
+    {
+      inconsistent.push_back(open.top().second);
+      open.pop();
+    }
+    for (auto& node : nodes)
+    {
+      node.closed = false;
+    }
+    for (int id : inconsistent)
+    {
+      open.push(OpenEntry(f(id), id));
+    }
+    inconsistent.clear();
+  }
+
+  // If no solution was found, the robot goes as close as possible to the target
+  std::vector<Footstep> path;
+  for (int id = (best_goal >= 0) ? best_goal : closest; id > 0; id = nodes[id].parent)
+  {
+    path.push_back(nodes[id].footstep);
+  }
+  footsteps.insert(footsteps.end(), path.rbegin(), path.rend());
+
+  // Adding last footstep to go double support
+  footsteps.push_back(clipped_opposite_footstep(footsteps.back()));
+}
+}  // namespace placo::humanoid
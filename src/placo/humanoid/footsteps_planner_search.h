@@ -0,0 +1,151 @@
+#pragma once
+
+#include "placo/humanoid/footsteps_planner.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace placo::humanoid
+{
+/**
+ * @brief Footsteps planner performing an anytime heuristic search (ARA*) over a discrete set of steps, optionally
+ * avoiding obstacles and costly areas of a 2D cost map.
+ *
+ * Each step of the action set is clipped using \ref HumanoidParameters::ellipsoid_clip (through
+ * clipped_opposite_footstep()). A first solution is searched with an inflated heuristic (\ref initial_epsilon),
+ * and is then improved by decreasing the inflation as long as the \ref max_time budget allows it.
+ */
+class FootstepsPlannerSearch : public FootstepsPlanner
+{
+public:
+  FootstepsPlannerSearch(HumanoidParameters& parameters);
+
+  /**
+   * @brief Return the type of footsteps planner
+   */
+  std::string name();
+
+  /**
+   * @brief Configure the targets of the search
+   * @param T_world_left_target Targetted frame for the left foot
+   * @param T_world_right_target Targetted frame for the right foot
+   */
+  void configure(Eigen::Affine3d T_world_left_target, Eigen::Affine3d T_world_right_target);
+
+  /**
+   * @brief Sets the cost map. Cell (i, j) covers the square of side resolution whose lower corner is origin + (i, j)
+   * * resolution. A foot can't overlap a cell whose value is above \ref obstacle_threshold, otherwise the maximum
+   * value of the cells it overlaps is added (scaled by \ref cost_weight) to the cost of the step. Outside of the map,
+   * the value is \ref outside_cost.
+   * @param cost_map cost map
+   * @param origin position of the lower corner of cell (0, 0) in the world
+   * @param resolution size of the cells [m]
+   */
+  void set_cost_map(Eigen::MatrixXd cost_map, Eigen::Vector2d origin, double resolution);
+
+  /**
+   * @brief Removes the cost map
+   */
+  void clear_cost_map();
+
+  /**
+   * @brief Cost of the map at a given world position
+   * @param position world position
+   */
+  double map_cost(Eigen::Vector2d position);
+
+  // Number of discrete values for the step along x, y and yaw
+  int actions_x = 5;
+  int actions_y = 3;
+  int actions_yaw = 3;
+
+  // Cost of a step, and weight of the cost map
+  double step_cost = 1.;
+  double cost_weight = 1.;
+
+  // Cost map values from which a cell is considered as an obstacle
+  double obstacle_threshold = 1.;
+
+  // Cost of the positions outside of the map (obstacles by default)
+  double outside_cost = std::numeric_limits<double>::infinity();
+
+  // Tolerance to consider that a foot reached its target
+  double goal_tolerance = 0.02;
+  double goal_yaw_tolerance = 0.1;
+
+  // Resolution used to discretize the footsteps in the closed set
+  double discretization_xy = 0.03;
+  double discretization_yaw = 0.15;
+
+  // Heuristic inflation of the first search, and decrease between each improvement
+  double initial_epsilon = 3.;
+  double epsilon_decrease = 0.5;
+
+  // Time budget [s] and maximum number of expanded nodes of the search
+  double max_time = 0.02;
+  int max_expansions = 50000;
+
+  // Maximum number of footsteps in a plan
+  int max_steps = 100;
+
+  /**
+   * @brief Number of nodes expanded during the last planning
+   */
+  int expansions = 0;
+
+  /**
+   * @brief Heuristic inflation of the search that found the last plan, 0 if the search was interrupted before a first
+   * solution was found. This is not a strict sub-optimality bound, since the heuristic can overestimate the cost to
+   * go (it doesn't account for the other foot reaching its target first) and footsteps are merged by discretization
+   */
+  double solution_epsilon = 0.;
+
+protected:
+  // Targetted position for the robot
+  Eigen::Affine3d T_world_targetLeft;
+  Eigen::Affine3d T_world_targetRight;
+
+  // Cost map
+  Eigen::MatrixXd cost_map;
+  Eigen::Vector2d cost_map_origin;
+  double cost_map_resolution = 0.;
+
+  struct Node
+  {
+    Footstep footstep;
+    double g;
+    double h;
+    int parent;
+    int depth;
+    bool closed;
+  };
+
+  // Discretized key of a footstep, used to hash the closed set
+  uint64_t footstep_key(const Footstep& footstep);
+
+  // Cost of the cell (i, j) of the map
+  double cell_cost(int i, int j);
+
+  // Cost to land on a given footstep (returns a negative value if the footstep is on an obstacle)
+  double footstep_cost(Footstep& footstep);
+
+  // Checks if a footstep is reached by a (clipped) step from another one
+  bool reachable(Footstep& from, const Footstep& to);
+
+  // Heuristic estimation of the cost to reach the target from a footstep
+  double heuristic(const Footstep& footstep);
+
+  // Checks if a footstep reached its target
+  bool is_goal(const Footstep& footstep);
+
+  /**
+   * @brief Generate the footsteps
+   * @param flying_side first step side
+   * @param T_world_left frame of the initial left foot
+   * @param T_world_right frame of the initial right foot
+   */
+  void plan_impl(std::vector<Footstep>& footsteps, HumanoidRobot::Side flying_side, Eigen::Affine3d T_world_left,
+                 Eigen::Affine3d T_world_right);
+};
+}  // namespace placo::humanoid
@@ -69,6 +69,29 @@ public:
    */
   int planned_timesteps = 100;
 
+  /**
+   * @brief Method used to plan the CoM trajectory
+   */
+  enum CoMPlanner
+  {
+    /**
+     * @brief QP over the CoM jerks for planned_timesteps, keeping the ZMP in the support polygons
+     */
+    JerkPlanner = 0,
+
+    /**
+     * @brief Closed-form DCM (capture point) planner, with no solver. The ZMP is constant in each support, except
+     * for the current one where it is adjusted (within the support polygon and zmp_margin) to reach the planned
+     * DCM. The initial acceleration and the final velocity are not constrained
+     */
+    DCMPlanner = 1
+  };
+
+  /**
+   * @brief CoM planner to use
+   */
+  CoMPlanner com_planner = JerkPlanner;
+
   /**
    * @brief Number of timesteps between each replan.
    * Support phases have to last longer than [replan_frequency * dt] or their duration has to be equal to 0
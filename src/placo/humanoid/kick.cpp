@@ -13,6 +13,16 @@ Eigen::Vector3d Kick::KickTrajectory::vel(double t)
   return foot_trajectory.vel(t);
 }
 
+Eigen::MatrixXd Kick::KickTrajectory::pos(const Eigen::VectorXd& ts)
+{
+  return foot_trajectory.pos(ts);
+}
+
+Eigen::MatrixXd Kick::KickTrajectory::vel(const Eigen::VectorXd& ts)
+{
+  return foot_trajectory.vel(ts);
+}
+
 Kick::KickTrajectory Kick::make_trajectory(HumanoidRobot::Side kicking_side, double t_start, double t_end,
                                            Eigen::Vector3d start, Eigen::Vector3d target,
                                            Eigen::Affine3d T_world_opposite, HumanoidParameters& parameters)
@@ -39,6 +49,9 @@ Kick::KickTrajectory Kick::make_trajectory(HumanoidRobot::Side kicking_side, dou
   trajectory.foot_trajectory.add_point(t_neutral, flying_neutral_position, Eigen::Vector3d::Zero());
   trajectory.foot_trajectory.add_point(t_end, target, Eigen::Vector3d::Zero());
 
+  // Fitting now, so that querying the trajectory doesn't modify it
+  trajectory.foot_trajectory.update();
+
   return trajectory;
 }
 }  // namespace placo::humanoid
\ No newline at end of file
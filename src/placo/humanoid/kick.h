@@ -14,6 +14,16 @@ public:
     Eigen::Vector3d pos(double t);
     Eigen::Vector3d vel(double t);
 
+    /**
+     * @brief Positions at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd pos(const Eigen::VectorXd& ts);
+
+    /**
+     * @brief Velocities at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd vel(const Eigen::VectorXd& ts);
+
     placo::tools::CubicSpline3D foot_trajectory;
   };
 
@@ -51,6 +51,12 @@ LIPM::LIPM(Problem& problem, int timesteps, double dt, Eigen::Vector2d initial_p
   y = Integrator(*y_var, Eigen::VectorXd(Eigen::Vector3d(initial_pos.y(), initial_vel.y(), initial_acc.y())), 3, dt);
 }
 
+void LIPM::set_initial_state(Eigen::Vector2d initial_pos, Eigen::Vector2d initial_vel, Eigen::Vector2d initial_acc)
+{
+  x.X0 = Eigen::VectorXd(Eigen::Vector3d(initial_pos.x(), initial_vel.x(), initial_acc.x()));
+  y.X0 = Eigen::VectorXd(Eigen::Vector3d(initial_pos.y(), initial_vel.y(), initial_acc.y()));
+}
+
 Expression LIPM::pos(int timestep)
 {
   return x.expr(timestep, 0) / y.expr(timestep, 0);
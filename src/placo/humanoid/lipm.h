@@ -30,6 +30,13 @@ public:
   LIPM(problem::Problem& problem, int timesteps, double dt, Eigen::Vector2d initial_pos,
        Eigen::Vector2d initial_vel = Eigen::Vector2d(0., 0.), Eigen::Vector2d initial_acc = Eigen::Vector2d(0., 0.));
 
+  /**
+   * @brief Updates the initial state, so that the LIPM (and its problem) can be reused for another solve with the
+   * same horizon. Expressions built before this call are not updated.
+   */
+  void set_initial_state(Eigen::Vector2d initial_pos, Eigen::Vector2d initial_vel = Eigen::Vector2d(0., 0.),
+                         Eigen::Vector2d initial_acc = Eigen::Vector2d(0., 0.));
+
   Trajectory get_trajectory();
 
   problem::Expression pos(int timestep);
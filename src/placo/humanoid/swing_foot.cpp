@@ -117,4 +117,30 @@ Eigen::Vector3d SwingFoot::Trajectory::vel(double t)
 
   return 3 * a * t_2 + 2 * b * t + c;
 }
+
+Eigen::MatrixXd SwingFoot::Trajectory::pos(const Eigen::VectorXd& ts)
+{
+  Eigen::ArrayXd t = ts.array() - t_start;
+
+  Eigen::MatrixXd result(3, ts.size());
+  for (int axis = 0; axis < 3; axis++)
+  {
+    result.row(axis) = (((a[axis] * t + b[axis]) * t + c[axis]) * t + d[axis]).matrix().transpose();
+  }
+
+  return result;
+}
+
+Eigen::MatrixXd SwingFoot::Trajectory::vel(const Eigen::VectorXd& ts)
+{
+  Eigen::ArrayXd t = ts.array() - t_start;
+
+  Eigen::MatrixXd result(3, ts.size());
+  for (int axis = 0; axis < 3; axis++)
+  {
+    result.row(axis) = ((3 * a[axis] * t + 2 * b[axis]) * t + c[axis]).matrix().transpose();
+  }
+
+  return result;
+}
 }  // namespace placo::humanoid
\ No newline at end of file
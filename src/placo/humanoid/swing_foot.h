@@ -18,6 +18,16 @@ public:
     Eigen::Vector3d pos(double t);
     Eigen::Vector3d vel(double t);
 
+    /**
+     * @brief Positions at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd pos(const Eigen::VectorXd& ts);
+
+    /**
+     * @brief Velocities at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd vel(const Eigen::VectorXd& ts);
+
     // Computed polynom (ax^3 + bx^2 + cx + d)
     Eigen::Vector3d a, b, c, d;
   };
@@ -14,6 +14,26 @@ Eigen::Vector3d SwingFootCubic::Trajectory::vel(double t)
   return Eigen::Vector3d(x.vel(t), y.vel(t), z.vel(t));
 }
 
+Eigen::MatrixXd SwingFootCubic::Trajectory::pos(const Eigen::VectorXd& ts)
+{
+  Eigen::MatrixXd result(3, ts.size());
+  result.row(0) = x.pos(ts).transpose();
+  result.row(1) = y.pos(ts).transpose();
+  result.row(2) = z.pos(ts).transpose();
+
+  return result;
+}
+
+Eigen::MatrixXd SwingFootCubic::Trajectory::vel(const Eigen::VectorXd& ts)
+{
+  Eigen::MatrixXd result(3, ts.size());
+  result.row(0) = x.vel(ts).transpose();
+  result.row(1) = y.vel(ts).transpose();
+  result.row(2) = z.vel(ts).transpose();
+
+  return result;
+}
+
 SwingFootCubic::Trajectory SwingFootCubic::make_trajectory(double t_start, double t_end, double height,
                                                            double rise_ratio, Eigen::Vector3d start,
                                                            Eigen::Vector3d target)
@@ -39,6 +59,11 @@ SwingFootCubic::Trajectory SwingFootCubic::make_trajectory(double t_start, doubl
   trajectory.y.add_point(t_end, target.y(), 0.);
   trajectory.z.add_point(t_end, target.z(), 0.);
 
+  // Fitting now, so that querying the trajectory doesn't modify it
+  trajectory.x.update();
+  trajectory.y.update();
+  trajectory.z.update();
+
   return trajectory;
 }
 
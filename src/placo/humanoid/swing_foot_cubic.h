@@ -18,6 +18,16 @@ public:
     virtual Eigen::Vector3d pos(double t);
     virtual Eigen::Vector3d vel(double t);
 
+    /**
+     * @brief Positions at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd pos(const Eigen::VectorXd& ts);
+
+    /**
+     * @brief Velocities at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd vel(const Eigen::VectorXd& ts);
+
     placo::tools::CubicSpline x;
     placo::tools::CubicSpline y;
     placo::tools::CubicSpline z;
@@ -106,4 +106,32 @@ Eigen::Vector3d SwingFootQuintic::Trajectory::vel(double t)
 
   return 5 * a * t_4 + 4 * b * t_3 + 3 * c * t_2 + 2 * d * t + e;
 }
+
+Eigen::MatrixXd SwingFootQuintic::Trajectory::pos(const Eigen::VectorXd& ts)
+{
+  Eigen::ArrayXd t = ts.array();
+
+  Eigen::MatrixXd result(3, ts.size());
+  for (int axis = 0; axis < 3; axis++)
+  {
+    result.row(axis) =
+        (((((a[axis] * t + b[axis]) * t + c[axis]) * t + d[axis]) * t + e[axis]) * t + f[axis]).matrix().transpose();
+  }
+
+  return result;
+}
+
+Eigen::MatrixXd SwingFootQuintic::Trajectory::vel(const Eigen::VectorXd& ts)
+{
+  Eigen::ArrayXd t = ts.array();
+
+  Eigen::MatrixXd result(3, ts.size());
+  for (int axis = 0; axis < 3; axis++)
+  {
+    result.row(axis) =
+        ((((5 * a[axis] * t + 4 * b[axis]) * t + 3 * c[axis]) * t + 2 * d[axis]) * t + e[axis]).matrix().transpose();
+  }
+
+  return result;
+}
 }  // namespace placo::humanoid
\ No newline at end of file
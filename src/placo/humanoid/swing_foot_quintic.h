@@ -16,6 +16,16 @@ public:
     Eigen::Vector3d pos(double t);
     Eigen::Vector3d vel(double t);
 
+    /**
+     * @brief Positions at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd pos(const Eigen::VectorXd& ts);
+
+    /**
+     * @brief Velocities at many times at once (3xK matrix)
+     */
+    Eigen::MatrixXd vel(const Eigen::VectorXd& ts);
+
     // Computed polynom (ax^5 + bx^4 + cx^3 + dx^2 + ex + f)
     Eigen::Vector3d a, b, c, d, e, f;
 
@@ -2,6 +2,10 @@
 #include "placo/humanoid/footsteps_planner.h"
 #include "placo/problem/polygon_constraint.h"
 #include "placo/tools/utils.h"
+#include <atomic>
+#include <limits>
+#include <map>
+#include <thread>
 
 namespace placo::humanoid
 {
@@ -30,57 +34,78 @@ static Eigen::Affine3d _buildFrame(Eigen::Vector3d position, double orientation)
   return frame;
 }
 
-static WalkPatternGenerator::TrajectoryPart& _findPart(std::vector<WalkPatternGenerator::TrajectoryPart>& parts,
-                                                       double t, int* index = nullptr)
+WalkPatternGenerator::TrajectoryPart& WalkPatternGenerator::Trajectory::find_part(double t, int* index)
 {
   if (parts.size() == 0)
   {
     throw std::runtime_error("Can't find a part in a trajectory that has 0 parts");
   }
 
-  int low = 0;
-  int high = parts.size() - 1;
+  // Each part covers [t_start, t_end[, except the first and last ones that are extended to cover the times before
+  // and after the trajectory
+  int last = parts.size() - 1;
+  auto contains = [&](int k) { return (k == 0 || t >= parts[k].t_start) && (k == last || t < parts[k].t_end); };
 
-  while (low != high)
-  {
-    int mid = (low + high) / 2;
-
-    WalkPatternGenerator::TrajectoryPart& part = parts[mid];
+  // Time is generally queried monotonically, the part is then either the last one found or the next one. This hint
+  // is kept per thread (and not in the trajectory) so that concurrent queries on a trajectory are safe
+  static thread_local int cursor = 0;
+  int found = -1;
 
-    if (t < part.t_start)
-    {
-      high = mid;
-    }
-    else if (t > part.t_end)
+  for (int candidate = std::min(cursor, last); candidate <= std::min(cursor + 1, last); candidate++)
+  {
+    if (contains(candidate))
     {
-      low = mid + 1;
+      found = candidate;
+      break;
     }
-    else
+  }
+
+  if (found < 0)
+  {
+    // Binary search of the last part starting before t
+    int low = 0;
+    int high = last;
+
+    while (low < high)
     {
-      return part;
+      int mid = (low + high + 1) / 2;
+
+      if (parts[mid].t_start <= t)
+      {
+        low = mid;
+      }
+      else
+      {
+        high = mid - 1;
+      }
     }
+    found = low;
   }
 
+  cursor = found;
   if (index != nullptr)
   {
-    *index = low;
+    *index = found;
   }
 
-  return parts[low];
+  return parts[found];
 }
 
-bool WalkPatternGenerator::Trajectory::is_flying(HumanoidRobot::Side side, double t)
+static bool _isFlying(WalkPatternGenerator::TrajectoryPart& part, HumanoidRobot::Side side)
 {
-  TrajectoryPart& part = _findPart(parts, t);
-
   return (!part.support.is_both() && part.support.side() == HumanoidRobot::other_side(side));
 }
 
+bool WalkPatternGenerator::Trajectory::is_flying(HumanoidRobot::Side side, double t)
+{
+  return _isFlying(find_part(t), side);
+}
+
 Eigen::Affine3d WalkPatternGenerator::Trajectory::get_T_world_left(double t)
 {
-  TrajectoryPart& part = _findPart(parts, t);
+  TrajectoryPart& part = find_part(t);
 
-  if (is_flying(HumanoidRobot::Left, t))
+  if (_isFlying(part, HumanoidRobot::Left))
   {
     if (part.kick_part)
     {
@@ -96,9 +121,9 @@ Eigen::Affine3d WalkPatternGenerator::Trajectory::get_T_world_left(double t)
 
 Eigen::Affine3d WalkPatternGenerator::Trajectory::get_T_world_right(double t)
 {
-  TrajectoryPart& part = _findPart(parts, t);
+  TrajectoryPart& part = find_part(t);
 
-  if (is_flying(HumanoidRobot::Right, t))
+  if (_isFlying(part, HumanoidRobot::Right))
   {
     if (part.kick_part)
     {
@@ -119,7 +144,7 @@ Eigen::Affine3d WalkPatternGenerator::Trajectory::get_T_world_foot(HumanoidRobot
 
 Eigen::Vector3d WalkPatternGenerator::Trajectory::get_v_world_left(double t)
 {
-  TrajectoryPart& part = _findPart(parts, t);
+  TrajectoryPart& part = find_part(t);
 
   if (part.support.side() == HumanoidRobot::Right)
   {
@@ -135,7 +160,7 @@ Eigen::Vector3d WalkPatternGenerator::Trajectory::get_v_world_left(double t)
 
 Eigen::Vector3d WalkPatternGenerator::Trajectory::get_v_world_right(double t)
 {
-  TrajectoryPart& part = _findPart(parts, t);
+  TrajectoryPart& part = find_part(t);
 
   if (part.support.side() == HumanoidRobot::Left)
   {
@@ -150,25 +175,29 @@ Eigen::Vector3d WalkPatternGenerator::Trajectory::get_v_world_right(double t)
 
 Eigen::Vector3d WalkPatternGenerator::Trajectory::get_p_world_CoM(double t)
 {
-  Eigen::Vector3d pos = Eigen::Vector3d(com.pos(t).x(), com.pos(t).y(), com_target_z);
+  Eigen::Vector2d com_pos = com.pos(t);
+  Eigen::Vector3d pos = Eigen::Vector3d(com_pos.x(), com_pos.y(), com_target_z);
   return T * pos;
 }
 
 Eigen::Vector3d WalkPatternGenerator::Trajectory::get_v_world_CoM(double t)
 {
-  Eigen::Vector3d vel = Eigen::Vector3d(com.vel(t).x(), com.vel(t).y(), 0);
+  Eigen::Vector2d com_vel = com.vel(t);
+  Eigen::Vector3d vel = Eigen::Vector3d(com_vel.x(), com_vel.y(), 0);
   return T.linear() * vel;
 }
 
 Eigen::Vector3d WalkPatternGenerator::Trajectory::get_a_world_CoM(double t)
 {
-  Eigen::Vector3d acc = Eigen::Vector3d(com.acc(t).x(), com.acc(t).y(), 0);
+  Eigen::Vector2d com_acc = com.acc(t);
+  Eigen::Vector3d acc = Eigen::Vector3d(com_acc.x(), com_acc.y(), 0);
   return T.linear() * acc;
 }
 
 Eigen::Vector3d WalkPatternGenerator::Trajectory::get_j_world_CoM(double t)
 {
-  Eigen::Vector3d jerk = Eigen::Vector3d(com.jerk(t).x(), com.jerk(t).y(), 0);
+  Eigen::Vector2d com_jerk = com.jerk(t);
+  Eigen::Vector3d jerk = Eigen::Vector3d(com_jerk.x(), com_jerk.y(), 0);
   return T.linear() * jerk;
 }
 
@@ -191,12 +220,12 @@ Eigen::Matrix3d WalkPatternGenerator::Trajectory::get_R_world_trunk(double t)
 
 HumanoidRobot::Side WalkPatternGenerator::Trajectory::support_side(double t)
 {
-  return _findPart(parts, t).support.side();
+  return find_part(t).support.side();
 }
 
 bool WalkPatternGenerator::Trajectory::support_is_both(double t)
 {
-  return _findPart(parts, t).support.is_both();
+  return find_part(t).support.is_both();
 }
 
 placo::tools::CubicSpline& WalkPatternGenerator::Trajectory::yaw(HumanoidRobot::Side side)
@@ -213,36 +242,34 @@ placo::tools::CubicSpline& WalkPatternGenerator::Trajectory::yaw(HumanoidRobot::
 
 FootstepsPlanner::Support WalkPatternGenerator::Trajectory::get_support(double t)
 {
-  TrajectoryPart& part = _findPart(parts, t);
+  TrajectoryPart& part = find_part(t);
   return T * part.support;
 }
 
 int WalkPatternGenerator::Trajectory::remaining_supports(double t)
 {
   int index;
-  _findPart(parts, t, &index);
+  find_part(t, &index);
 
   return parts.size() - index - 1;
 }
 
 FootstepsPlanner::Support WalkPatternGenerator::Trajectory::get_next_support(double t, int n)
 {
-  TrajectoryPart part = _findPart(parts, t);
-  for (int i = 0; i < n; i++)
-  {
-    part = _findPart(parts, part.t_end + 1e-4);
-  }
-  return T * part.support;
+  int index;
+  find_part(t, &index);
+  index = std::min<int>(index + n, parts.size() - 1);
+
+  return T * parts[index].support;
 }
 
 FootstepsPlanner::Support WalkPatternGenerator::Trajectory::get_prev_support(double t, int n)
 {
-  TrajectoryPart part = _findPart(parts, t);
-  for (int i = 0; i < n; i++)
-  {
-    part = _findPart(parts, part.t_start - 1e-4);
-  }
-  return T * part.support;
+  int index;
+  find_part(t, &index);
+  index = std::max<int>(index - n, 0);
+
+  return T * parts[index].support;
 }
 
 std::vector<FootstepsPlanner::Support> WalkPatternGenerator::Trajectory::get_supports()
@@ -264,14 +291,79 @@ void WalkPatternGenerator::Trajectory::apply_transform(Eigen::Affine3d T_)
 
 double WalkPatternGenerator::Trajectory::get_part_t_start(double t)
 {
-  TrajectoryPart part = _findPart(parts, t);
-  return part.t_start;
+  return find_part(t).t_start;
 }
 
 double WalkPatternGenerator::Trajectory::get_part_t_end(double t)
 {
-  TrajectoryPart part = _findPart(parts, t);
-  return part.t_end;
+  return find_part(t).t_end;
+}
+
+WalkPatternGenerator::Trajectory::Samples WalkPatternGenerator::Trajectory::sample_grid(double t0, double t1, double dt)
+{
+  if (dt <= 0)
+  {
+    throw std::runtime_error("WalkPatternGenerator::Trajectory::sample_grid: dt should be positive");
+  }
+
+  int n = std::max<int>(0, std::floor((t1 - t0) / dt + 1e-9) + 1);
+  double omega = LIPM::compute_omega(com_target_z);
+  double omega_2 = omega * omega;
+
+  Samples samples;
+  samples.ts = Eigen::VectorXd::LinSpaced(n, t0, t0 + (n - 1) * dt);
+
+  // CoM is evaluated at once on the whole grid
+  Eigen::MatrixXd com_local[3];
+  for (int diff = 0; diff < 3; diff++)
+  {
+    com_local[diff] = Eigen::MatrixXd(n, 2);
+    com_local[diff].col(0) = com.x.values(samples.ts, diff);
+    com_local[diff].col(1) = com.y.values(samples.ts, diff);
+  }
+
+  samples.com_pos.resize(n, 3);
+  samples.com_vel.resize(n, 3);
+  samples.com_acc.resize(n, 3);
+  samples.zmp.resize(n, 2);
+  samples.dcm.resize(n, 2);
+  samples.left_pos.resize(n, 3);
+  samples.left_yaw.resize(n);
+  samples.right_pos.resize(n, 3);
+  samples.right_yaw.resize(n);
+  samples.trunk_yaw.resize(n);
+  samples.support_side.resize(n);
+  samples.support_is_both.resize(n);
+
+  // Time is increasing, parts are then found in O(1) by find_part()
+  for (int k = 0; k < n; k++)
+  {
+    double t = samples.ts[k];
+
+    Eigen::Vector3d pos = T * Eigen::Vector3d(com_local[0](k, 0), com_local[0](k, 1), com_target_z);
+    Eigen::Vector3d vel = T.linear() * Eigen::Vector3d(com_local[1](k, 0), com_local[1](k, 1), 0);
+    Eigen::Vector3d acc = T.linear() * Eigen::Vector3d(com_local[2](k, 0), com_local[2](k, 1), 0);
+
+    samples.com_pos.row(k) = pos.transpose();
+    samples.com_vel.row(k) = vel.transpose();
+    samples.com_acc.row(k) = acc.transpose();
+    samples.zmp.row(k) = (pos.head(2) - (1 / omega_2) * acc.head(2)).transpose();
+    samples.dcm.row(k) = (pos.head(2) + (1 / omega) * vel.head(2)).transpose();
+
+    Eigen::Affine3d T_world_left = get_T_world_left(t);
+    Eigen::Affine3d T_world_right = get_T_world_right(t);
+    samples.left_pos.row(k) = T_world_left.translation().transpose();
+    samples.left_yaw[k] = frame_yaw(T_world_left.rotation());
+    samples.right_pos.row(k) = T_world_right.translation().transpose();
+    samples.right_yaw[k] = frame_yaw(T_world_right.rotation());
+    samples.trunk_yaw[k] = frame_yaw(get_R_world_trunk(t));
+
+    TrajectoryPart& part = find_part(t);
+    samples.support_side[k] = part.support.side();
+    samples.support_is_both[k] = part.support.is_both();
+  }
+
+  return samples;
 }
 
 int WalkPatternGenerator::support_timesteps(FootstepsPlanner::Support& support)
@@ -296,6 +388,236 @@ int WalkPatternGenerator::support_timesteps(FootstepsPlanner::Support& support)
   }
 }
 
+Eigen::Vector2d WalkPatternGenerator::support_zmp_target(FootstepsPlanner::Support& support)
+{
+  double y_offset = 0.;
+  if (!support.is_both())
+  {
+    y_offset = support.kick() ? parameters.kick_zmp_target_y : parameters.foot_zmp_target_y;
+
+    if (support.side() == HumanoidRobot::Right)
+    {
+      y_offset = -y_offset;
+    }
+  }
+
+  double x_offset = support.kick() ? parameters.kick_zmp_target_x : parameters.foot_zmp_target_x;
+
+  Eigen::Vector3d zmp_target = support.frame() * Eigen::Vector3d(x_offset, y_offset, 0);
+  return zmp_target.head(2);
+}
+
+// Moves p along the segment from target to p, so that it lies in the polygon shrunk by margin (target is assumed to
+// be inside it)
+static Eigen::Vector2d clamp_in_polygon(const tools::Polygon2d& polygon, double margin, const Eigen::Vector2d& target,
+                                        const Eigen::Vector2d& p)
+{
+  tools::Polygon2d::Normals normals;
+  tools::Polygon2d::Offsets offsets;
+  polygon.half_planes(normals, offsets);
+
+  Eigen::Vector2d delta = p - target;
+  double ratio = 1.;
+  for (int i = 0; i < polygon.size(); i++)
+  {
+    double slack = normals(i, 0) * target.x() + normals(i, 1) * target.y() - offsets[i] - margin;
+    double rate = normals(i, 0) * delta.x() + normals(i, 1) * delta.y();
+
+    if (rate < 0)
+    {
+      ratio = std::min(ratio, std::max(0., slack / -rate));
+    }
+  }
+
+  return target + ratio * delta;
+}
+
+void WalkPatternGenerator::planCoMDCM(Trajectory& trajectory, int timesteps, int kept_timesteps,
+                                      Eigen::Vector2d initial_pos, Eigen::Vector2d initial_vel,
+                                      Trajectory* old_trajectory)
+{
+  double dt = parameters.dt();
+
+  // The ZMP is constant during each support, the DCM being at the end of the last support
+  std::vector<Eigen::Vector2d> zmps;
+  std::vector<double> durations;
+  std::vector<tools::Polygon2d> polygons;
+  for (auto& support : trajectory.supports)
+  {
+    int step_timesteps = support_timesteps(support);
+    if (step_timesteps > 0)
+    {
+      zmps.push_back(support_zmp_target(support));
+      durations.push_back(step_timesteps * dt);
+      polygons.push_back(support.support_polygon2d());
+    }
+  }
+
+  if (zmps.size() == 0)
+  {
+    throw std::runtime_error("WalkPatternGenerator: can't plan the DCM with no support");
+  }
+
+  // Backward recursion of the DCM at the start of each support: xi_start = p + exp(-omega T) (xi_end - p)
+  std::vector<Eigen::Vector2d> dcm_starts(zmps.size());
+  Eigen::Vector2d dcm_end = zmps.back();
+  for (int i = zmps.size() - 1; i >= 0; i--)
+  {
+    dcm_starts[i] = zmps[i] + exp(-omega * durations[i]) * (dcm_end - zmps[i]);
+    dcm_end = dcm_starts[i];
+  }
+
+  // Keyframes and jerks, in the format of the jerk planner trajectories
+  std::vector<Eigen::Vector3d> x_keyframes(timesteps + 1);
+  std::vector<Eigen::Vector3d> y_keyframes(timesteps + 1);
+
+  // The kept timesteps are copied from the former trajectory
+  for (int timestep = 0; timestep <= kept_timesteps && timestep <= timesteps; timestep++)
+  {
+    double t = trajectory.t_start + timestep * dt;
+    Eigen::Vector3d pos = old_trajectory->get_p_world_CoM(t);
+    Eigen::Vector3d vel = old_trajectory->get_v_world_CoM(t);
+    Eigen::Vector3d acc = old_trajectory->get_a_world_CoM(t);
+    x_keyframes[timestep] = Eigen::Vector3d(pos.x(), vel.x(), acc.x());
+    y_keyframes[timestep] = Eigen::Vector3d(pos.y(), vel.y(), acc.y());
+  }
+
+  // Closed-form LIPM solution for the remaining timesteps, starting from the current CoM and DCM
+  int first_timestep = std::min(kept_timesteps, timesteps);
+  Eigen::Vector2d com = initial_pos;
+  Eigen::Vector2d dcm = initial_pos + initial_vel / omega;
+  if (first_timestep > 0)
+  {
+    com = Eigen::Vector2d(x_keyframes[first_timestep][0], y_keyframes[first_timestep][0]);
+    dcm = com + Eigen::Vector2d(x_keyframes[first_timestep][1], y_keyframes[first_timestep][1]) / omega;
+  }
+
+  // Finding the support of the first planned timestep
+  double t_segment = first_timestep * dt;
+  double t_support_end = durations[0];
+  size_t support = 0;
+  while (support < zmps.size() - 1 && t_segment >= t_support_end - 1e-9)
+  {
+    support += 1;
+    t_support_end += durations[support];
+  }
+
+  bool new_segment = true;
+  Eigen::Vector2d zmp;
+
+  for (int timestep = first_timestep; timestep <= timesteps; timestep++)
+  {
+    double t = timestep * dt;
+
+    // Entering a new segment (constant ZMP) when the support changes
+    while (support < zmps.size() - 1 && t >= t_support_end - 1e-9)
+    {
+      double tau = t_support_end - t_segment;
+      com = zmp + exp(-omega * tau) * (com - zmp) + sinh(omega * tau) * (dcm - zmp);
+      dcm = zmp + exp(omega * tau) * (dcm - zmp);
+      t_segment = t_support_end;
+      new_segment = true;
+
+      support += 1;
+      t_support_end += durations[support];
+    }
+
+    if (new_segment)
+    {
+      // The ZMP of the segment is chosen so that the current DCM reaches the planned one at the end of the support
+      new_segment = false;
+      Eigen::Vector2d dcm_target = (support < zmps.size() - 1) ? dcm_starts[support + 1] : zmps.back();
+      double remaining = t_support_end - t_segment;
+
+      if (support == zmps.size() - 1 || remaining < 1e-9)
+      {
+        zmp = zmps[support];
+      }
+      else
+      {
+        // If the DCM can't be reached with a ZMP in the support polygon, the ZMP is moved back toward the support
+        // target, the error on the DCM is then caught up by the next supports
+        double e = exp(omega * remaining);
+        zmp = (e * dcm - dcm_target) / (e - 1);
+        zmp = clamp_in_polygon(polygons[support], parameters.zmp_margin, zmps[support], zmp);
+      }
+    }
+
+    double tau = t - t_segment;
+    Eigen::Vector2d c = zmp + exp(-omega * tau) * (com - zmp) + sinh(omega * tau) * (dcm - zmp);
+    Eigen::Vector2d xi = zmp + exp(omega * tau) * (dcm - zmp);
+    Eigen::Vector2d v = omega * (xi - c);
+    Eigen::Vector2d a = omega_2 * (c - zmp);
+
+    x_keyframes[timestep] = Eigen::Vector3d(c.x(), v.x(), a.x());
+    y_keyframes[timestep] = Eigen::Vector3d(c.y(), v.y(), a.y());
+  }
+
+  LIPM::Trajectory com_trajectory;
+  problem::Integrator::Trajectory* trajectories[2] = { &com_trajectory.x, &com_trajectory.y };
+  std::vector<Eigen::Vector3d>* keyframes[2] = { &x_keyframes, &y_keyframes };
+
+  for (int axis = 0; axis < 2; axis++)
+  {
+    problem::Integrator::Trajectory& axis_trajectory = *trajectories[axis];
+    axis_trajectory.M = problem::Integrator::upper_shift_matrix(3);
+    axis_trajectory.order = 3;
+    axis_trajectory.chain = true;
+    axis_trajectory.dt = dt;
+    axis_trajectory.t_start = trajectory.t_start;
+    axis_trajectory.variable_value = Eigen::VectorXd(timesteps);
+    axis_trajectory.keyframes.resize(3, timesteps + 1);
+
+    for (int timestep = 0; timestep <= timesteps; timestep++)
+    {
+      axis_trajectory.keyframes.col(timestep) = (*keyframes[axis])[timestep];
+
+      // Piecewise constant jerk, interpolating the acceleration between keyframes
+      if (timestep < timesteps)
+      {
+        axis_trajectory.variable_value[timestep] =
+            ((*keyframes[axis])[timestep + 1][2] - (*keyframes[axis])[timestep][2]) / dt;
+      }
+    }
+  }
+
+  trajectory.com = com_trajectory;
+}
+
+WalkPatternGenerator::CoMProblem::CoMProblem(int timesteps, double dt, double omega_2)
+  : timesteps(timesteps), dt(dt), omega_2(omega_2), lipm(problem, timesteps, dt, Eigen::Vector2d::Zero())
+{
+  problem.warm_start = true;
+
+  for (int timestep = 0; timestep < timesteps; timestep++)
+  {
+    zmps.push_back(lipm.zmp(timestep, omega_2));
+  }
+}
+
+bool WalkPatternGenerator::CoMProblem::matches(int timesteps_, double dt_, double omega_2_) const
+{
+  return timesteps == timesteps_ && dt == dt_ && omega_2 == omega_2_;
+}
+
+void WalkPatternGenerator::CoMProblem::set_initial_state(Eigen::Vector2d initial_pos, Eigen::Vector2d initial_vel,
+                                                         Eigen::Vector2d initial_acc)
+{
+  lipm.set_initial_state(initial_pos, initial_vel, initial_acc);
+
+  // Only the constant part of the ZMP expressions (zmp = pos - acc / omega^2) depends on the initial state
+  Eigen::Vector3d x0(initial_pos.x(), initial_vel.x(), initial_acc.x());
+  Eigen::Vector3d y0(initial_pos.y(), initial_vel.y(), initial_acc.y());
+
+  for (int timestep = 0; timestep < timesteps; timestep++)
+  {
+    const Eigen::MatrixXd& A = lipm.x.a_powers[timestep];
+    Eigen::Vector3d x = A * x0;
+    Eigen::Vector3d y = A * y0;
+    zmps[timestep].b << x[0] - x[2] / omega_2, y[0] - y[2] / omega_2;
+  }
+}
+
 // XXX : No more management of the CoM height while kicking
 void WalkPatternGenerator::planCoM(Trajectory& trajectory, Eigen::Vector2d initial_pos, Eigen::Vector2d initial_vel,
                                    Eigen::Vector2d initial_acc, Trajectory* old_trajectory, double t_replan)
@@ -331,11 +653,47 @@ void WalkPatternGenerator::planCoM(Trajectory& trajectory, Eigen::Vector2d initi
   }
   trajectory.kept_ts = kept_timesteps;
 
-  // Creating the planner
-  Problem problem = Problem();
-  LIPM lipm = LIPM(problem, timesteps, parameters.dt(), initial_pos, initial_vel, initial_acc);
+  if (parameters.com_planner == HumanoidParameters::DCMPlanner)
+  {
+    planCoMDCM(trajectory, timesteps, old_trajectory != nullptr ? kept_timesteps : 0, initial_pos, initial_vel,
+               old_trajectory);
+    return;
+  }
+
+  // Creating the planner, or reusing the one of the previous call in this thread if it has the same horizon
+  static thread_local std::unique_ptr<CoMProblem> com_problem;
+  if (com_problem == nullptr || !com_problem->matches(timesteps, parameters.dt(), omega_2))
+  {
+    com_problem = std::make_unique<CoMProblem>(timesteps, parameters.dt(), omega_2);
+  }
+  com_problem->set_initial_state(initial_pos, initial_vel, initial_acc);
+
+  Problem& problem = com_problem->problem;
+  problem.clear_constraints();
+  LIPM& lipm = com_problem->lipm;
   lipm.t_start = trajectory.t_start;
 
+  // The half-planes that were active in the old trajectory, shifted to the new timesteps, are a guess of the active
+  // set used to warm start the problem
+  std::map<int, std::vector<Eigen::Vector3d>> old_active_half_planes;
+  if (old_trajectory != nullptr)
+  {
+    int shift = std::lround((trajectory.t_start - old_trajectory->t_start) / parameters.dt());
+    for (auto& entry : old_trajectory->com_active_half_planes)
+    {
+      old_active_half_planes[entry.first - shift].push_back(entry.second);
+    }
+  }
+
+  // ZMP constraint of each support, with its half-planes and constrained timesteps
+  struct SupportZMPs
+  {
+    ProblemConstraint* constraint;
+    PolygonConstraint::HalfPlanes half_planes;
+    std::vector<int> timesteps;
+  };
+  std::vector<SupportZMPs> supports_zmps;
+
   // We ensure that the first tile of the old trajectory starts with the same jerks as initially planned
   if (old_trajectory != nullptr)
   {
@@ -354,60 +712,58 @@ void WalkPatternGenerator::planCoM(Trajectory& trajectory, Eigen::Vector2d initi
   {
     current_support = trajectory.supports[i];
     int step_timesteps = support_timesteps(current_support);
+    std::vector<Expression> support_zmps;
+    std::vector<int> zmp_timesteps;
 
     for (int timestep = constrained_timesteps; timestep < fmin(timesteps, constrained_timesteps + step_timesteps); timestep++)
     {
-      // Ensuring ZMP remains in the support polygon
+      const Expression& zmp = com_problem->zmps[timestep];
+
       if (timestep > kept_timesteps)
       {
-        problem.add_constraint(PolygonConstraint::in_polygon_xy(
-            lipm.zmp(timestep, omega_2), current_support.support_polygon(), parameters.zmp_margin));
+        support_zmps.push_back(zmp);
+        zmp_timesteps.push_back(timestep);
       }
-      
+
       // ZMP reference trajectory : aiming for the center of single supports
       if (!current_support.is_both() || current_support.start || current_support.end)
       {
-        double y_offset = 0.;
-        if (!current_support.is_both())
+        problem.add_constraint(zmp == support_zmp_target(current_support))
+            .configure(ProblemConstraint::Soft, parameters.zmp_reference_weight);
+      }
+    }
+
+    // Ensuring ZMP remains in the support polygon, the half-planes are computed once for the whole support
+    if (support_zmps.size() > 0)
+    {
+      // The polygon is computed on the trajectory support, so that it can be reused when replanning
+      PolygonConstraint::HalfPlanes half_planes(trajectory.supports[i].support_polygon2d(), parameters.zmp_margin);
+      ProblemConstraint& constraint = problem.add_constraint(half_planes.apply(support_zmps));
+
+      // Rows are guessed active if the same half-plane was active at this timestep in the old trajectory
+      int edges = half_planes.normals.rows();
+      for (size_t k = 0; k < zmp_timesteps.size(); k++)
+      {
+        auto old_active = old_active_half_planes.find(zmp_timesteps[k]);
+        if (old_active == old_active_half_planes.end())
         {
-          if (current_support.side() == HumanoidRobot::Left)
-          {
-            if (current_support.kick())
-            {
-              y_offset = parameters.kick_zmp_target_y;
-            }
-            else
-            {
-              y_offset = parameters.foot_zmp_target_y;
-            }
-          }
-          else
+          continue;
+        }
+
+        for (auto& half_plane : old_active->second)
+        {
+          for (int edge = 0; edge < edges; edge++)
           {
-            if (current_support.kick())
-            {
-              y_offset = -parameters.kick_zmp_target_y;
-            }
-            else
+            if ((half_planes.normals.row(edge).transpose() - half_plane.head(2)).norm() < 1e-9 &&
+                fabs(half_planes.offsets[edge] - half_plane[2]) < 1e-9)
             {
-              y_offset = -parameters.foot_zmp_target_y;
+              constraint.active_rows.push_back(k * edges + edge);
             }
           }
         }
-
-        double x_offset = 0.;
-        if (current_support.kick())
-        {
-          x_offset = parameters.kick_zmp_target_x;
-        }
-        else
-        {
-          x_offset = parameters.foot_zmp_target_x;
-        }
-
-        Eigen::Vector3d zmp_target = current_support.frame() * Eigen::Vector3d(x_offset, y_offset, 0);
-        problem.add_constraint(lipm.zmp(timestep, omega_2) == zmp_target.head(2))
-            .configure(ProblemConstraint::Soft, parameters.zmp_reference_weight);
       }
+
+      supports_zmps.push_back(SupportZMPs{ &constraint, half_planes, zmp_timesteps });
     }
 
     constrained_timesteps += step_timesteps;
@@ -430,6 +786,18 @@ void WalkPatternGenerator::planCoM(Trajectory& trajectory, Eigen::Vector2d initi
 
   problem.solve();
   trajectory.com = lipm.get_trajectory();
+
+  for (auto& support_zmps : supports_zmps)
+  {
+    int edges = support_zmps.half_planes.normals.rows();
+    for (int row : support_zmps.constraint->active_rows)
+    {
+      int edge = row % edges;
+      Eigen::Vector3d half_plane(support_zmps.half_planes.normals(edge, 0), support_zmps.half_planes.normals(edge, 1),
+                                 support_zmps.half_planes.offsets[edge]);
+      trajectory.com_active_half_planes.push_back(std::make_pair(support_zmps.timesteps[row / edges], half_plane));
+    }
+  }
 }
 
 void WalkPatternGenerator::Trajectory::add_supports(double t, FootstepsPlanner::Support& support)
@@ -487,7 +855,7 @@ void WalkPatternGenerator::planSingleSupportTrajectory(TrajectoryPart& part, Tra
   // Current step case
   if (part.support.replanned)
   {
-    auto& old_part = _findPart(old_trajectory->parts, t_replan);
+    auto& old_part = old_trajectory->find_part(t_replan);
 
     part.swing_trajectory = SwingFootCubic::make_trajectory(
         old_part.t_start, old_part.t_end, parameters.walk_foot_height, parameters.walk_foot_rise_ratio,
@@ -567,6 +935,11 @@ void WalkPatternGenerator::planFeetTrajectories(Trajectory& trajectory, Trajecto
     trajectory.parts.push_back(part);
   }
 
+  // Fitting the yaw splines now, so that querying the trajectory doesn't modify it (concurrent queries are then safe)
+  trajectory.left_foot_yaw.update();
+  trajectory.right_foot_yaw.update();
+  trajectory.trunk_yaw.update();
+
   trajectory.t_end = t;
 }
 
@@ -622,6 +995,86 @@ WalkPatternGenerator::Trajectory WalkPatternGenerator::replan(std::vector<Footst
   return trajectory;
 }
 
+std::vector<WalkPatternGenerator::PlanResult>
+WalkPatternGenerator::plan_batch(const std::vector<PlanJob>& jobs, int threads, bool keep_trajectories)
+{
+  std::vector<PlanResult> results(jobs.size());
+
+  auto run_job = [&](int k) {
+    // The job has its own parameters, generator and problem, so that no state is shared between threads (the robot
+    // is not used by plan())
+    HumanoidParameters job_parameters = jobs[k].parameters;
+    std::vector<FootstepsPlanner::Support> supports = jobs[k].supports;
+    WalkPatternGenerator wpg(robot, job_parameters);
+    PlanResult& result = results[k];
+
+    try
+    {
+      Trajectory trajectory = wpg.plan(supports, jobs[k].initial_com_world, jobs[k].t_start);
+      Trajectory::Samples samples = trajectory.sample_grid(trajectory.t_start, trajectory.t_end, job_parameters.dt());
+
+      result.duration = trajectory.t_end - trajectory.t_start;
+      result.max_com_vel = samples.com_vel.rowwise().norm().maxCoeff();
+      result.max_com_acc = samples.com_acc.rowwise().norm().maxCoeff();
+
+      // The support half-planes are only computed when the part changes
+      result.min_zmp_margin = std::numeric_limits<double>::infinity();
+      int current_index = -1;
+      PolygonConstraint::HalfPlanes half_planes = PolygonConstraint::HalfPlanes(std::vector<Eigen::Vector2d>());
+
+      for (int i = 0; i < samples.ts.size(); i++)
+      {
+        int index;
+        TrajectoryPart& part = trajectory.find_part(samples.ts[i], &index);
+        if (index != current_index)
+        {
+          half_planes = PolygonConstraint::HalfPlanes(part.support.support_polygon2d());
+          current_index = index;
+        }
+
+        Eigen::VectorXd distances = half_planes.normals * samples.zmp.row(i).transpose() - half_planes.offsets;
+        result.min_zmp_margin = std::min(result.min_zmp_margin, distances.minCoeff());
+      }
+
+      if (keep_trajectories)
+      {
+        result.trajectory = trajectory;
+      }
+      result.success = true;
+    }
+    catch (std::exception& e)
+    {
+      result.error = e.what();
+    }
+  };
+
+  // Worker threads take the next job until all are planned
+  if (threads <= 0)
+  {
+    threads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+  threads = std::min<int>(threads, jobs.size());
+
+  std::atomic<int> next_job(0);
+  std::vector<std::thread> workers;
+  for (int thread = 0; thread < threads; thread++)
+  {
+    workers.push_back(std::thread([&]() {
+      for (int k = next_job++; k < (int)jobs.size(); k = next_job++)
+      {
+        run_job(k);
+      }
+    }));
+  }
+
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  return results;
+}
+
 bool WalkPatternGenerator::can_replan_supports(Trajectory& trajectory, double t_replan)
 {
   // We can't replan from an "end", a "start" or a "kick"
@@ -679,6 +1132,9 @@ std::vector<FootstepsPlanner::Support> WalkPatternGenerator::replan_supports(Foo
     supports.erase(supports.begin());
   }
 
+  // The supports kept from the current trajectory don't need their convex hull to be computed again
+  FootstepsPlanner::reuse_polygons(supports, trajectory.supports);
+
   supports[0].replanned = true;
   return supports;
 }
@@ -100,6 +100,41 @@ public:
      */
     double get_part_t_end(double t);
 
+    /**
+     * @brief Trajectory sampled on a regular time grid, with one row per sample
+     */
+    struct Samples
+    {
+      Eigen::VectorXd ts;
+
+      // CoM position, velocity and acceleration (N x 3)
+      Eigen::MatrixXd com_pos;
+      Eigen::MatrixXd com_vel;
+      Eigen::MatrixXd com_acc;
+
+      // ZMP and DCM (N x 2)
+      Eigen::MatrixXd zmp;
+      Eigen::MatrixXd dcm;
+
+      // Feet positions (N x 3) and yaws
+      Eigen::MatrixXd left_pos;
+      Eigen::VectorXd left_yaw;
+      Eigen::MatrixXd right_pos;
+      Eigen::VectorXd right_yaw;
+
+      // Trunk yaw (pitch and roll are constant, see trunk_pitch and trunk_roll)
+      Eigen::VectorXd trunk_yaw;
+
+      // Support side (see HumanoidRobot::Side) and whether the support is a double support
+      Eigen::VectorXi support_side;
+      Eigen::VectorXi support_is_both;
+    };
+
+    /**
+     * @brief Samples the trajectory from t0 to t1 (included) with the given dt, in a single pass
+     */
+    Samples sample_grid(double t0, double t1, double dt);
+
     // Number of dt planned by the jerk planner
     int jerk_planner_timesteps = 0;
 
@@ -115,9 +150,22 @@ public:
     // A part is the support and the swing trajectory
     std::vector<TrajectoryPart> parts;
 
+    /**
+     * @brief Finds the part corresponding to the given time. A part covers [t_start, t_end[ (at a boundary, the next
+     * part is returned), the first and last parts also cover the times before and after the trajectory. It can be
+     * called concurrently from several threads.
+     * @param t time
+     * @param index if not null, the index of the part is stored here
+     */
+    TrajectoryPart& find_part(double t, int* index = nullptr);
+
     // CoM trajectories
     LIPM::Trajectory com;
 
+    // ZMP half-planes that are active in the CoM problem solution (timestep from t_start, normal and offset), used
+    // to warm start the problem when replanning
+    std::vector<std::pair<int, Eigen::Vector3d>> com_active_half_planes;
+
     // Feet trajectory
     placo::tools::CubicSpline left_foot_yaw;
     placo::tools::CubicSpline right_foot_yaw;
@@ -136,8 +184,53 @@ public:
     friend class WalkPatternGenerator;
   };
 
+  /**
+   * @brief A planning job for plan_batch(), carrying its own copy of the parameters
+   */
+  struct PlanJob
+  {
+    std::vector<FootstepsPlanner::Support> supports;
+    HumanoidParameters parameters;
+    Eigen::Vector3d initial_com_world = Eigen::Vector3d::Zero();
+    double t_start = 0.;
+  };
+
+  /**
+   * @brief Result of a planning job, with summary metrics computed on a dt grid
+   */
+  struct PlanResult
+  {
+    // Whether the planning succeeded (else, error contains the error message)
+    bool success = false;
+    std::string error;
+
+    // Planned trajectory (only if the trajectories were requested)
+    Trajectory trajectory;
+
+    // Trajectory duration [s]
+    double duration = 0.;
+
+    // Minimum distance [m] of the ZMP to the edges of its support polygon (negative if outside)
+    double min_zmp_margin = 0.;
+
+    // Maximum CoM velocity [m/s] and acceleration [m/s^2] norms
+    double max_com_vel = 0.;
+    double max_com_acc = 0.;
+  };
+
   WalkPatternGenerator(HumanoidRobot& robot, HumanoidParameters& parameters);
 
+  /**
+   * @brief Plans many jobs in parallel. Each job is planned by its own WalkPatternGenerator (and thus its own
+   * problem) using its own parameters, on a pool of threads.
+   * @param jobs jobs to plan
+   * @param threads number of threads (0 to use the hardware concurrency)
+   * @param keep_trajectories if false, only the summary metrics are returned
+   * @return results, in the same order as the jobs
+   */
+  std::vector<PlanResult> plan_batch(const std::vector<PlanJob>& jobs, int threads = 0,
+                                     bool keep_trajectories = true);
+
   /**
    * @brief Plan a walk trajectory following given footsteps based on the parameters of the WPG
    * @param supports Supports generated from the foosteps to follow
@@ -177,6 +270,36 @@ protected:
   double omega;
   double omega_2;
 
+  /**
+   * @brief The jerk planner problem. Its variables and ZMP expressions only depend on the horizon, so it is kept
+   * alive between the planCoM() calls of a thread (receding horizon), only the initial state and the constraints
+   * being updated.
+   */
+  struct CoMProblem
+  {
+    CoMProblem(int timesteps, double dt, double omega_2);
+
+    /**
+     * @brief Checks if this problem has the given horizon
+     */
+    bool matches(int timesteps, double dt, double omega_2) const;
+
+    /**
+     * @brief Updates the initial state of the LIPM, and the ZMP expressions accordingly
+     */
+    void set_initial_state(Eigen::Vector2d initial_pos, Eigen::Vector2d initial_vel, Eigen::Vector2d initial_acc);
+
+    int timesteps;
+    double dt;
+    double omega_2;
+
+    problem::Problem problem;
+    LIPM lipm;
+
+    // ZMP expression for each timestep
+    std::vector<problem::Expression> zmps;
+  };
+
   void planCoM(Trajectory& trajectory, Eigen::Vector2d initial_pos,
                Eigen::Vector2d initial_vel = Eigen::Vector2d::Zero(),
                Eigen::Vector2d initial_acc = Eigen::Vector2d::Zero(), Trajectory* old_trajectory = nullptr,
@@ -189,6 +312,27 @@ protected:
   void planSingleSupportTrajectory(TrajectoryPart& part, Trajectory& trajectory, int step, double& t,
                                    Trajectory* old_trajectory, double t_replan);
 
+  /**
+   * @brief Closed-form CoM planner: backward recursion of the DCM at the end of each support, the ZMP being
+   * constant during each support. Used instead of the jerk QP when \ref HumanoidParameters::com_planner is
+   * DCMPlanner.
+   *
+   * The ZMP of each support is kept in its support polygon, shrunk by \ref HumanoidParameters::zmp_margin.
+   * Compared to the jerk planner, the following are not supported:
+   * - the initial acceleration: the acceleration jumps to the one given by the ZMP of the current support,
+   * - the final conditions: the DCM converges to the last support, but the velocity is not exactly zero at the
+   *   end of the horizon,
+   * - the ZMP reference weight: the ZMP is exactly at the target of each support (see \ref support_zmp_target),
+   *   which is the only kick-specific handling (the horizon is extended the same way as for the jerk planner).
+   */
+  void planCoMDCM(Trajectory& trajectory, int timesteps, int kept_timesteps, Eigen::Vector2d initial_pos,
+                  Eigen::Vector2d initial_vel, Trajectory* old_trajectory);
+
+  /**
+   * @brief ZMP reference for a given support (world frame)
+   */
+  Eigen::Vector2d support_zmp_target(FootstepsPlanner::Support& support);
+
   int support_timesteps(FootstepsPlanner::Support& support);
 };
 }  // namespace placo::humanoid
\ No newline at end of file
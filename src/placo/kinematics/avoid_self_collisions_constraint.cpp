@@ -5,7 +5,8 @@ namespace placo::kinematics
 {
 void AvoidSelfCollisionsConstraint::add_constraint(placo::problem::Problem& problem)
 {
-  std::vector<model::RobotWrapper::Distance> distances = solver->robot.distances();
+  // Pairs farther than the trigger distance are culled by the broad phase
+  solver->robot.distances(distances, self_collisions_trigger);
 
   int constraints = 0;
 
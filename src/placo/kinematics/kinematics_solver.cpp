@@ -359,7 +359,9 @@ Eigen::VectorXd KinematicsSolver::solve(bool apply)
 
   if (apply)
   {
-    robot.state.q = pinocchio::integrate(robot.model, robot.state.q, qd_sol);
+    // Copying the result to keep state.q storage (see RobotWrapper::reset())
+    Eigen::VectorXd q = pinocchio::integrate(robot.model, robot.state.q, qd_sol);
+    robot.state.q = q;
     if (dt > 0)
     {
       auto qd_save = robot.state.qd;
@@ -0,0 +1,478 @@
+#include "placo/model/model_cache.h"
+#include "pinocchio/serialization/model.hpp"
+#include <hpp/fcl/BVH/BVH_model.h>
+#include <hpp/fcl/shape/geometric_shapes.h>
+#include <hpp/fcl/shape/convex.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace placo::model
+{
+const uint32_t ModelCache::version = 2;
+
+// FNV-1a hash, updated with the content of a file
+static void hash_file(uint64_t& hash, const std::string& filename)
+{
+  std::ifstream f(filename, std::ios::binary);
+  char buffer[4096];
+
+  while (f.read(buffer, sizeof(buffer)) || f.gcount() > 0)
+  {
+    for (std::streamsize k = 0; k < f.gcount(); k++)
+    {
+      hash ^= (unsigned char)buffer[k];
+      hash *= 1099511628211ULL;
+    }
+  }
+}
+
+template <typename T>
+static void write(std::ostream& stream, const T& value)
+{
+  stream.write((const char*)&value, sizeof(T));
+}
+
+template <typename T>
+static T read(std::istream& stream)
+{
+  T value{};
+  stream.read((char*)&value, sizeof(T));
+  return value;
+}
+
+// Number of bytes remaining in the stream
+static uint64_t remaining(std::istream& stream)
+{
+  std::streampos position = stream.tellg();
+  stream.seekg(0, std::ios::end);
+  std::streampos end = stream.tellg();
+  stream.seekg(position);
+
+  return (stream && end >= position) ? (uint64_t)(end - position) : 0;
+}
+
+// Reads a number of items of item_size bytes each. If the stream doesn't contain them, 0 is returned and the stream
+// is marked as failed, so that corrupted sizes never lead to huge allocations
+static uint32_t read_count(std::istream& stream, uint64_t item_size)
+{
+  uint32_t count = read<uint32_t>(stream);
+
+  if (!stream || count * item_size > remaining(stream))
+  {
+    stream.setstate(std::ios::failbit);
+    return 0;
+  }
+
+  return count;
+}
+
+static void write_string(std::ostream& stream, const std::string& str)
+{
+  write<uint32_t>(stream, str.size());
+  stream.write(str.data(), str.size());
+}
+
+static std::string read_string(std::istream& stream)
+{
+  std::string str(read_count(stream, 1), '\0');
+  stream.read(&str[0], str.size());
+  return str;
+}
+
+template <typename Derived>
+static void write_matrix(std::ostream& stream, const Eigen::MatrixBase<Derived>& matrix)
+{
+  for (int k = 0; k < matrix.size(); k++)
+  {
+    write<double>(stream, matrix(k));
+  }
+}
+
+template <typename Derived>
+static void read_matrix(std::istream& stream, Eigen::MatrixBase<Derived>& matrix)
+{
+  for (int k = 0; k < matrix.size(); k++)
+  {
+    matrix(k) = read<double>(stream);
+  }
+}
+
+// Size and modification time of a mesh file, used to check that it didn't change since the cache was written
+static std::pair<uint64_t, int64_t> file_stamp(const std::string& filename)
+{
+  if (!fs::is_regular_file(filename))
+  {
+    return std::make_pair(0, 0);
+  }
+
+  return std::make_pair(fs::file_size(filename), fs::last_write_time(filename).time_since_epoch().count());
+}
+
+ModelCache::ModelCache(const std::string& urdf_filename, const std::string& collisions_filename, int flags)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  hash_file(hash, urdf_filename);
+  if (collisions_filename != "")
+  {
+    hash_file(hash, collisions_filename);
+  }
+  hash = (hash ^ (uint64_t)flags) * 1099511628211ULL;
+  hash = (hash ^ (uint64_t)version) * 1099511628211ULL;
+
+  std::ostringstream oss;
+  oss << (fs::path(urdf_filename).parent_path() / ".placo_cache").string() << "/" << std::hex << std::setw(16)
+      << std::setfill('0') << hash;
+  filename = oss.str();
+}
+
+bool ModelCache::load(pinocchio::Model& model, pinocchio::GeometryModel& collision_model,
+                      pinocchio::GeometryModel* visual_model)
+{
+  // The models are loaded separately, so that the output models are left untouched if the cache is corrupted
+  pinocchio::Model cached_model;
+  pinocchio::GeometryModel cached_collision_model, cached_visual_model;
+
+  try
+  {
+    if (!fs::is_regular_file(filename + ".model") || !fs::is_regular_file(filename + ".geometry"))
+    {
+      return false;
+    }
+
+    std::ifstream f(filename + ".geometry", std::ios::binary);
+    if (read<uint32_t>(f) != version || !f)
+    {
+      return false;
+    }
+
+    // Checking that the meshes were not modified
+    uint32_t meshes = read_count(f, sizeof(uint32_t) + sizeof(uint64_t) + sizeof(int64_t));
+    for (uint32_t k = 0; k < meshes && f; k++)
+    {
+      std::string mesh = read_string(f);
+      uint64_t size = read<uint64_t>(f);
+      int64_t time = read<int64_t>(f);
+
+      if (!f || file_stamp(mesh) != std::make_pair(size, time))
+      {
+        return false;
+      }
+    }
+
+    if (!load_geometry_model(f, cached_collision_model))
+    {
+      return false;
+    }
+
+    uint32_t pairs = read_count(f, 2 * sizeof(uint64_t));
+    for (uint32_t k = 0; k < pairs && f; k++)
+    {
+      uint64_t first = read<uint64_t>(f);
+      uint64_t second = read<uint64_t>(f);
+
+      if (!f || first >= cached_collision_model.geometryObjects.size() ||
+          second >= cached_collision_model.geometryObjects.size())
+      {
+        return false;
+      }
+      cached_collision_model.addCollisionPair(pinocchio::CollisionPair(first, second));
+    }
+
+    // The visual model is stored last, so that it is not even read when it is not requested
+    bool has_visual = read<uint8_t>(f);
+    if (!f || (visual_model != nullptr && (!has_visual || !load_geometry_model(f, cached_visual_model))))
+    {
+      return false;
+    }
+
+    cached_model.loadFromBinary(filename + ".model");
+
+    // Geometries should be attached to existing joints and frames
+    for (auto geometry_model : { &cached_collision_model, &cached_visual_model })
+    {
+      for (auto& object : geometry_model->geometryObjects)
+      {
+        if (object.parentJoint >= (pinocchio::JointIndex)cached_model.njoints ||
+            object.parentFrame >= (pinocchio::FrameIndex)cached_model.nframes)
+        {
+          return false;
+        }
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    return false;
+  }
+
+  model = cached_model;
+  collision_model = cached_collision_model;
+  if (visual_model != nullptr)
+  {
+    *visual_model = cached_visual_model;
+  }
+
+  return true;
+}
+
+void ModelCache::save(const pinocchio::Model& model, const pinocchio::GeometryModel& collision_model,
+                      const pinocchio::GeometryModel* visual_model)
+{
+  std::ostringstream stream;
+
+  try
+  {
+    write<uint32_t>(stream, version);
+
+    std::set<std::string> meshes;
+    for (auto& geometry_model : { &collision_model, visual_model })
+    {
+      if (geometry_model == nullptr)
+      {
+        continue;
+      }
+
+      for (auto& object : geometry_model->geometryObjects)
+      {
+        if (object.meshPath != "")
+        {
+          meshes.insert(object.meshPath);
+        }
+      }
+    }
+    write<uint32_t>(stream, meshes.size());
+    for (auto& mesh : meshes)
+    {
+      auto stamp = file_stamp(mesh);
+      write_string(stream, mesh);
+      write<uint64_t>(stream, stamp.first);
+      write<int64_t>(stream, stamp.second);
+    }
+
+    save_geometry_model(stream, collision_model);
+
+    write<uint32_t>(stream, collision_model.collisionPairs.size());
+    for (auto& pair : collision_model.collisionPairs)
+    {
+      write<uint64_t>(stream, pair.first);
+      write<uint64_t>(stream, pair.second);
+    }
+
+    write<uint8_t>(stream, visual_model != nullptr);
+    if (visual_model != nullptr)
+    {
+      save_geometry_model(stream, *visual_model);
+    }
+
+    // The files are written under temporary names and renamed, so that another process never reads a partially
+    // written cache. The geometry file is renamed last, since its presence marks the cache as complete
+    fs::create_directories(fs::path(filename).parent_path());
+    std::string suffix = ".tmp" + std::to_string(std::random_device()());
+    model.saveToBinary(filename + ".model" + suffix);
+
+    std::ofstream f(filename + ".geometry" + suffix, std::ios::binary);
+    f << stream.str();
+    f.close();
+    if (!f)
+    {
+      fs::remove(filename + ".model" + suffix);
+      fs::remove(filename + ".geometry" + suffix);
+      throw std::runtime_error("can't write " + filename + ".geometry" + suffix);
+    }
+
+    fs::rename(filename + ".model" + suffix, filename + ".model");
+    fs::rename(filename + ".geometry" + suffix, filename + ".geometry");
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "WARNING: Can't write model cache (" << e.what() << ")" << std::endl;
+  }
+}
+
+void ModelCache::save_geometry_model(std::ostream& stream, const pinocchio::GeometryModel& geometry_model)
+{
+  write<uint32_t>(stream, geometry_model.geometryObjects.size());
+
+  for (auto& object : geometry_model.geometryObjects)
+  {
+    write_string(stream, object.name);
+    write<uint64_t>(stream, object.parentFrame);
+    write<uint64_t>(stream, object.parentJoint);
+    write_matrix(stream, object.placement.rotation());
+    write_matrix(stream, object.placement.translation());
+    write_string(stream, object.meshPath);
+    write_matrix(stream, object.meshScale);
+    write<uint8_t>(stream, object.overrideMaterial);
+    write_matrix(stream, object.meshColor);
+    write_string(stream, object.meshTexturePath);
+
+    hpp::fcl::CollisionGeometry* geometry = object.geometry.get();
+    hpp::fcl::NODE_TYPE type = geometry->getNodeType();
+    write<int32_t>(stream, type);
+
+    if (type == hpp::fcl::BV_OBBRSS)
+    {
+      auto bvh = (hpp::fcl::BVHModel<hpp::fcl::OBBRSS>*)geometry;
+      write<uint32_t>(stream, bvh->num_vertices);
+      for (unsigned int k = 0; k < bvh->num_vertices; k++)
+      {
+        write_matrix(stream, bvh->vertices[k]);
+      }
+      write<uint32_t>(stream, bvh->num_tris);
+      for (unsigned int k = 0; k < bvh->num_tris; k++)
+      {
+        for (int i = 0; i < 3; i++)
+        {
+          write<uint64_t>(stream, bvh->tri_indices[k][i]);
+        }
+      }
+    }
+    else if (type == hpp::fcl::GEOM_CONVEX)
+    {
+      auto convex = (hpp::fcl::ConvexBase*)geometry;
+      write<uint32_t>(stream, convex->num_points);
+      for (unsigned int k = 0; k < convex->num_points; k++)
+      {
+        write_matrix(stream, convex->points[k]);
+      }
+    }
+    else if (type == hpp::fcl::GEOM_BOX)
+    {
+      write_matrix(stream, ((hpp::fcl::Box*)geometry)->halfSide);
+    }
+    else if (type == hpp::fcl::GEOM_SPHERE)
+    {
+      write<double>(stream, ((hpp::fcl::Sphere*)geometry)->radius);
+    }
+    else if (type == hpp::fcl::GEOM_CYLINDER)
+    {
+      write<double>(stream, ((hpp::fcl::Cylinder*)geometry)->radius);
+      write<double>(stream, ((hpp::fcl::Cylinder*)geometry)->halfLength);
+    }
+    else if (type == hpp::fcl::GEOM_CAPSULE)
+    {
+      write<double>(stream, ((hpp::fcl::Capsule*)geometry)->radius);
+      write<double>(stream, ((hpp::fcl::Capsule*)geometry)->halfLength);
+    }
+    else
+    {
+      std::ostringstream oss;
+      oss << "geometry " << object.name << " can't be serialized";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+bool ModelCache::load_geometry_model(std::istream& stream, pinocchio::GeometryModel& geometry_model)
+{
+  uint32_t count = read_count(stream, 1);
+
+  for (uint32_t k = 0; k < count && stream; k++)
+  {
+    std::string name = read_string(stream);
+    pinocchio::FrameIndex parent_frame = read<uint64_t>(stream);
+    pinocchio::JointIndex parent_joint = read<uint64_t>(stream);
+    Eigen::Matrix3d rotation;
+    Eigen::Vector3d translation;
+    read_matrix(stream, rotation);
+    read_matrix(stream, translation);
+    std::string mesh_path = read_string(stream);
+    Eigen::Vector3d mesh_scale;
+    read_matrix(stream, mesh_scale);
+    bool override_material = read<uint8_t>(stream);
+    Eigen::Vector4d mesh_color;
+    read_matrix(stream, mesh_color);
+    std::string mesh_texture_path = read_string(stream);
+
+    std::shared_ptr<hpp::fcl::CollisionGeometry> geometry;
+    int32_t type = read<int32_t>(stream);
+
+    if (type == hpp::fcl::BV_OBBRSS)
+    {
+      std::vector<hpp::fcl::Vec3f> vertices(read_count(stream, 3 * sizeof(double)));
+      for (auto& vertex : vertices)
+      {
+        read_matrix(stream, vertex);
+      }
+      std::vector<hpp::fcl::Triangle> triangles(read_count(stream, 3 * sizeof(uint64_t)));
+      for (auto& triangle : triangles)
+      {
+        uint64_t a = read<uint64_t>(stream);
+        uint64_t b = read<uint64_t>(stream);
+        uint64_t c = read<uint64_t>(stream);
+
+        if (!stream || a >= vertices.size() || b >= vertices.size() || c >= vertices.size())
+        {
+          return false;
+        }
+        triangle.set(a, b, c);
+      }
+
+      auto bvh = std::make_shared<hpp::fcl::BVHModel<hpp::fcl::OBBRSS>>();
+      bvh->beginModel();
+      bvh->addSubModel(vertices, triangles);
+      bvh->endModel();
+      geometry = bvh;
+    }
+    else if (type == hpp::fcl::GEOM_CONVEX)
+    {
+      std::vector<hpp::fcl::Vec3f> points(read_count(stream, 3 * sizeof(double)));
+      for (auto& point : points)
+      {
+        read_matrix(stream, point);
+      }
+      if (!stream)
+      {
+        return false;
+      }
+      geometry = std::shared_ptr<hpp::fcl::CollisionGeometry>(
+          hpp::fcl::ConvexBase::convexHull(points.data(), points.size(), false));
+    }
+    else if (type == hpp::fcl::GEOM_BOX)
+    {
+      Eigen::Vector3d half_side;
+      read_matrix(stream, half_side);
+      geometry = std::make_shared<hpp::fcl::Box>(2 * half_side);
+    }
+    else if (type == hpp::fcl::GEOM_SPHERE)
+    {
+      geometry = std::make_shared<hpp::fcl::Sphere>(read<double>(stream));
+    }
+    else if (type == hpp::fcl::GEOM_CYLINDER)
+    {
+      double radius = read<double>(stream);
+      double half_length = read<double>(stream);
+      geometry = std::make_shared<hpp::fcl::Cylinder>(radius, 2 * half_length);
+    }
+    else if (type == hpp::fcl::GEOM_CAPSULE)
+    {
+      double radius = read<double>(stream);
+      double half_length = read<double>(stream);
+      geometry = std::make_shared<hpp::fcl::Capsule>(radius, 2 * half_length);
+    }
+    else
+    {
+      return false;
+    }
+
+    if (!stream)
+    {
+      return false;
+    }
+
+    geometry_model.addGeometryObject(pinocchio::GeometryObject(name, parent_frame, parent_joint, geometry,
+                                                               pinocchio::SE3(rotation, translation), mesh_path,
+                                                               mesh_scale, override_material, mesh_color,
+                                                               mesh_texture_path));
+  }
+
+  return (bool)stream;
+}
+}  // namespace placo::model
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/geometry.hpp"
+#include <string>
+
+namespace placo::model
+{
+/**
+ * @brief Binary cache of the robot models, avoiding to parse the URDF and load the meshes at each startup.
+ *
+ * The cache is stored in a ``.placo_cache`` directory next to the URDF file. It is keyed by a hash of the URDF,
+ * the ``collisions.json`` file and the loading flags, and checks that the meshes were not modified since it was
+ * written.
+ */
+class ModelCache
+{
+public:
+  /**
+   * @brief Creates a cache for a given URDF file
+   * @param urdf_filename path to the URDF file
+   * @param collisions_filename path to the collisions.json file (empty if not used)
+   * @param flags flags used to load the robot (see \ref RobotWrapper::Flags)
+   */
+  ModelCache(const std::string& urdf_filename, const std::string& collisions_filename, int flags);
+
+  /**
+   * @brief Loads the models from the cache
+   * @param model pinocchio model
+   * @param collision_model pinocchio collision model (including collision pairs)
+   * @param visual_model pinocchio visual model, nullptr if it should not be loaded from the cache
+   * @return true if the cache was valid and loaded, the models are left untouched otherwise (the caller is then
+   * expected to build them and to \ref save them, replacing the invalid cache). A truncated or corrupted cache is
+   * considered invalid, this never throws
+   */
+  bool load(pinocchio::Model& model, pinocchio::GeometryModel& collision_model,
+            pinocchio::GeometryModel* visual_model);
+
+  /**
+   * @brief Saves the models to the cache. If a geometry can't be serialized, a warning is issued and no cache
+   * is written. The files are replaced atomically, so that concurrent loads never see a partial cache.
+   * @param model pinocchio model
+   * @param collision_model pinocchio collision model (including collision pairs)
+   * @param visual_model pinocchio visual model, nullptr if it should not be cached (its meshes are then not
+   * checked either)
+   */
+  void save(const pinocchio::Model& model, const pinocchio::GeometryModel& collision_model,
+            const pinocchio::GeometryModel* visual_model);
+
+  /**
+   * @brief Path to the cache files (without extension)
+   */
+  std::string filename;
+
+  /**
+   * @brief Version of the cache format, to be increased when it changes
+   */
+  static const uint32_t version;
+
+protected:
+  void save_geometry_model(std::ostream& stream, const pinocchio::GeometryModel& geometry_model);
+  bool load_geometry_model(std::istream& stream, pinocchio::GeometryModel& geometry_model);
+};
+}  // namespace placo::model
@@ -1,4 +1,5 @@
 #include "placo/model/robot_wrapper.h"
+#include "placo/model/model_cache.h"
 #include "pinocchio/algorithm/center-of-mass-derivatives.hpp"
 #include "pinocchio/algorithm/center-of-mass.hpp"
 #include "pinocchio/algorithm/compute-all-terms.hpp"
@@ -7,6 +8,8 @@
 #include "pinocchio/algorithm/crba.hpp"
 #include "pinocchio/algorithm/centroidal.hpp"
 #include "placo/tools/utils.h"
+#include <hpp/fcl/BVH/BVH_model.h>
+#include <hpp/fcl/shape/convex.h>
 #include <json/json.h>
 #include <filesystem>
 #include <algorithm>
@@ -16,10 +19,8 @@ namespace fs = std::filesystem;
 namespace placo::model
 {
 RobotWrapper::RobotWrapper(std::string model_directory, int flags, std::string urdf_content)
-  : model_directory(model_directory)
+  : model_directory(model_directory), flags(flags), urdf_content(urdf_content)
 {
-  std::string urdf_filename;
-
   if (fs::is_regular_file(model_directory))
   {
     fs::path path = model_directory;
@@ -31,58 +32,66 @@ RobotWrapper::RobotWrapper(std::string model_directory, int flags, std::string u
     urdf_filename = model_directory + "/robot.urdf";
   }
 
-  if (urdf_content != "")
-  {
-    pinocchio::urdf::buildModelFromXML(urdf_content, root_joint, model);
-    std::istringstream stream(urdf_content);
-    pinocchio::urdf::buildGeom(model, stream, pinocchio::COLLISION, collision_model, model_directory);
-  }
-  else
+  mesh_directory = model_directory;
+
+  // Using the binary model cache, if enabled
+  std::string collisions_filename = model_directory + "/collisions.json";
+  bool use_collisions_file = !(flags & IGNORE_COLLISIONS) && tools::file_exists(collisions_filename);
+  std::shared_ptr<ModelCache> cache;
+  bool cached = false;
+
+  if ((flags & MODEL_CACHE) && urdf_content == "")
   {
-    pinocchio::urdf::buildModel(urdf_filename, root_joint, model);
-    pinocchio::urdf::buildGeom(model, urdf_filename, pinocchio::COLLISION, collision_model, model_directory);
+    cache = std::make_shared<ModelCache>(urdf_filename, use_collisions_file ? collisions_filename : "", flags);
+    // With LAZY_VISUAL, the visual model is kept out of the cache, it is loaded from the URDF on first access
+    cached = cache->load(model, collision_model, (flags & LAZY_VISUAL) ? nullptr : &visual_model);
+    visual_model_loaded = cached && !(flags & LAZY_VISUAL);
   }
 
-  if (flags & COLLISION_AS_VISUAL)
+  if (!cached)
   {
     if (urdf_content != "")
     {
+      pinocchio::urdf::buildModelFromXML(urdf_content, root_joint, model);
       std::istringstream stream(urdf_content);
-      pinocchio::urdf::buildGeom(model, stream, pinocchio::COLLISION, visual_model, model_directory);
+      pinocchio::urdf::buildGeom(model, stream, pinocchio::COLLISION, collision_model, model_directory);
     }
     else
     {
-      pinocchio::urdf::buildGeom(model, urdf_filename, pinocchio::COLLISION, visual_model, model_directory);
+      pinocchio::urdf::buildModel(urdf_filename, root_joint, model);
+      pinocchio::urdf::buildGeom(model, urdf_filename, pinocchio::COLLISION, collision_model, model_directory);
     }
-  }
-  else
-  {
-    if (urdf_content != "")
+
+    if (!(flags & LAZY_VISUAL))
     {
-      std::istringstream stream(urdf_content);
-      pinocchio::urdf::buildGeom(model, stream, pinocchio::VISUAL, visual_model, model_directory);
+      load_visual_model();
     }
-    else
+
+    if (flags & CONVEX_COLLISIONS)
     {
-      pinocchio::urdf::buildGeom(model, urdf_filename, pinocchio::VISUAL, visual_model, model_directory);
+      make_collisions_convex(urdf_content == "" ? urdf_filename + ".convex" : "");
     }
-  }
 
-  // Load collisions pairs
-  if (!(flags & IGNORE_COLLISIONS))
-  {
-    if (tools::file_exists(model_directory + "/collisions.json"))
+    // Load collisions pairs
+    if (use_collisions_file)
     {
-      load_collision_pairs(model_directory + "/collisions.json");
+      load_collision_pairs(collisions_filename);
     }
-    else
+    else if (!(flags & IGNORE_COLLISIONS))
     {
       collision_model.addAllCollisionPairs();
     }
+
+    if (cache != nullptr)
+    {
+      cache->save(model, collision_model, (flags & LAZY_VISUAL) ? nullptr : &visual_model);
+    }
   }
 
+  build_lookups();
+
   // Creating data
-  data = new pinocchio::Data(model);
+  data = std::make_unique<pinocchio::Data>(model);
 
   // Assuming that motors with limits both equals to zero are not defined in the
   // URDF, setting them to the maximum possible value
@@ -99,7 +108,8 @@ RobotWrapper::RobotWrapper(std::string model_directory, int flags, std::string u
   pinocchio::computeAllTerms(model, *data, state.q, state.qd);
   update_kinematics();
 
-  auto collisions = self_collisions();
+  // The self collisions in neutral position were already reported when the cache was written
+  auto collisions = cached ? std::vector<Collision>() : self_collisions();
   if (collisions.size() > 0)
   {
     std::cerr << "WARNING: Robot has the following self collisions in neutral position:" << std::endl;
@@ -111,6 +121,220 @@ RobotWrapper::RobotWrapper(std::string model_directory, int flags, std::string u
   }
 }
 
+// Version of the convex hulls cache file format, to be increased when it changes
+static const uint32_t convex_cache_version = 1;
+
+void RobotWrapper::make_collisions_convex(const std::string& cache_filename)
+{
+  std::vector<std::vector<hpp::fcl::Vec3f>> hulls;
+
+  if (!load_convex_cache(cache_filename, hulls))
+  {
+    hulls.clear();
+    hulls.resize(collision_model.geometryObjects.size());
+
+    for (size_t k = 0; k < collision_model.geometryObjects.size(); k++)
+    {
+      auto bvh = std::dynamic_pointer_cast<hpp::fcl::BVHModelBase>(collision_model.geometryObjects[k].geometry);
+
+      if (bvh != nullptr)
+      {
+        bvh->buildConvexHull(false);
+        for (unsigned int i = 0; i < bvh->convex->num_points; i++)
+        {
+          hulls[k].push_back(bvh->convex->points[i]);
+        }
+      }
+    }
+
+    if (cache_filename != "")
+    {
+      std::ofstream f(cache_filename, std::ios::binary);
+      if (f.is_open())
+      {
+        uint32_t count = hulls.size();
+        f.write((const char*)&convex_cache_version, sizeof(uint32_t));
+        f.write((const char*)&count, sizeof(uint32_t));
+
+        for (size_t k = 0; k < hulls.size(); k++)
+        {
+          const std::string& name = collision_model.geometryObjects[k].name;
+          uint32_t name_size = name.size();
+          uint32_t num_points = hulls[k].size();
+          f.write((const char*)&name_size, sizeof(uint32_t));
+          f.write(name.data(), name_size);
+          f.write((const char*)&num_points, sizeof(uint32_t));
+          for (auto& point : hulls[k])
+          {
+            f.write((const char*)point.data(), 3 * sizeof(double));
+          }
+        }
+      }
+      else
+      {
+        std::cerr << "WARNING: Can't write convex hulls cache to " << cache_filename << std::endl;
+      }
+    }
+  }
+
+  invalidate_collision_data();
+
+  for (size_t k = 0; k < collision_model.geometryObjects.size(); k++)
+  {
+    if (hulls[k].size() > 0)
+    {
+      // The convex hull of the hull vertices is cheap to compute, and is the same as the one of the original mesh
+      collision_model.geometryObjects[k].geometry = std::shared_ptr<hpp::fcl::CollisionGeometry>(
+          hpp::fcl::ConvexBase::convexHull(hulls[k].data(), hulls[k].size(), false));
+    }
+  }
+}
+
+bool RobotWrapper::load_convex_cache(const std::string& cache_filename,
+                                     std::vector<std::vector<hpp::fcl::Vec3f>>& hulls)
+{
+  if (cache_filename == "" || !fs::is_regular_file(cache_filename))
+  {
+    return false;
+  }
+
+  // The cache is discarded if the URDF or any mesh were modified after it was written
+  auto cache_time = fs::last_write_time(cache_filename);
+  std::vector<std::string> sources;
+  sources.push_back(cache_filename.substr(0, cache_filename.size() - std::string(".convex").size()));
+  for (auto& object : collision_model.geometryObjects)
+  {
+    sources.push_back(object.meshPath);
+  }
+  for (auto& source : sources)
+  {
+    if (fs::is_regular_file(source) && fs::last_write_time(source) > cache_time)
+    {
+      return false;
+    }
+  }
+
+  std::ifstream f(cache_filename, std::ios::binary);
+  uint32_t version = 0, count = 0;
+  f.read((char*)&version, sizeof(uint32_t));
+  f.read((char*)&count, sizeof(uint32_t));
+
+  if (!f || version != convex_cache_version || count != collision_model.geometryObjects.size())
+  {
+    return false;
+  }
+
+  // Sizes read from the file are checked against the remaining bytes before allocating, so that a truncated or
+  // corrupted cache is discarded
+  uintmax_t file_size = fs::file_size(cache_filename);
+  auto remaining = [&]() -> uintmax_t { return file_size - (uintmax_t)f.tellg(); };
+
+  hulls.resize(count);
+  for (size_t k = 0; k < count; k++)
+  {
+    uint32_t name_size = 0, num_points = 0;
+    f.read((char*)&name_size, sizeof(uint32_t));
+    if (!f || name_size > remaining())
+    {
+      return false;
+    }
+
+    std::string name(name_size, '\0');
+    f.read(&name[0], name_size);
+    f.read((char*)&num_points, sizeof(uint32_t));
+
+    if (!f || name != collision_model.geometryObjects[k].name || (uintmax_t)num_points * 3 * sizeof(double) > remaining())
+    {
+      return false;
+    }
+
+    hulls[k].resize(num_points);
+    for (auto& point : hulls[k])
+    {
+      f.read((char*)point.data(), 3 * sizeof(double));
+    }
+  }
+
+  return (bool)f;
+}
+
+RobotWrapper::RobotWrapper(const RobotWrapper& other)
+  : state(other.state)
+  , model_directory(other.model_directory)
+  , model(other.model)
+  , collision_model(other.collision_model)
+  , visual_model(other.visual_model)
+  , flags(other.flags)
+  , urdf_filename(other.urdf_filename)
+  , urdf_content(other.urdf_content)
+  , mesh_directory(other.mesh_directory)
+  , joint_indices(other.joint_indices)
+  , frame_indices(other.frame_indices)
+  , visual_model_loaded(other.visual_model_loaded)
+{
+  // Copying geometry objects only copies the pointers to their collision geometries. The collision data is built
+  // right away, since it updates the bounding volumes of these (shared) geometries: the instances can then be
+  // used concurrently
+  data = std::make_unique<pinocchio::Data>(*other.data);
+  get_collision_data();
+}
+
+RobotWrapper& RobotWrapper::operator=(const RobotWrapper& other)
+{
+  if (this != &other)
+  {
+    state = other.state;
+    model_directory = other.model_directory;
+    model = other.model;
+    collision_model = other.collision_model;
+    visual_model = other.visual_model;
+    flags = other.flags;
+    urdf_filename = other.urdf_filename;
+    urdf_content = other.urdf_content;
+    mesh_directory = other.mesh_directory;
+    joint_indices = other.joint_indices;
+    frame_indices = other.frame_indices;
+    visual_model_loaded = other.visual_model_loaded;
+    root_joint = other.root_joint;
+
+    // Same as the copy constructor, the data is copied and the collision data is rebuilt for this instance
+    data = std::make_unique<pinocchio::Data>(*other.data);
+    invalidate_collision_data();
+    get_collision_data();
+  }
+
+  return *this;
+}
+
+void RobotWrapper::load_visual_model()
+{
+  // The collision geometry can be used as visual, which avoids loading the visual meshes
+  pinocchio::GeometryType type = (flags & COLLISION_AS_VISUAL) ? pinocchio::COLLISION : pinocchio::VISUAL;
+
+  visual_model = pinocchio::GeometryModel();
+  if (urdf_content != "")
+  {
+    std::istringstream stream(urdf_content);
+    pinocchio::urdf::buildGeom(model, stream, type, visual_model, mesh_directory);
+  }
+  else
+  {
+    pinocchio::urdf::buildGeom(model, urdf_filename, type, visual_model, mesh_directory);
+  }
+
+  visual_model_loaded = true;
+}
+
+pinocchio::GeometryModel& RobotWrapper::get_visual_model()
+{
+  if (!visual_model_loaded)
+  {
+    load_visual_model();
+  }
+
+  return visual_model;
+}
+
 bool RobotWrapper::Collision::operator==(const Collision& other)
 {
   return (objA == other.objA && objB == other.objB);
@@ -123,19 +347,69 @@ bool RobotWrapper::Distance::operator==(const Distance& other)
 
 void RobotWrapper::reset()
 {
-  state = neutral_state();
+  // State vectors are copied rather than moved, so that their storage (which can be shared with numpy arrays) is
+  // kept
+  State neutral = neutral_state();
+  state.q = neutral.q;
+  state.qd = neutral.qd;
+  state.qdd = neutral.qdd;
+}
+
+void RobotWrapper::build_lookups()
+{
+  joint_indices.clear();
+  for (pinocchio::JointIndex k = 0; k < (pinocchio::JointIndex)model.njoints; k++)
+  {
+    joint_indices.emplace(model.names[k], k);
+  }
+
+  // If several frames have the same name, the first one is used (as in pinocchio's getFrameId)
+  frame_indices.clear();
+  for (pinocchio::FrameIndex k = 0; k < model.frames.size(); k++)
+  {
+    frame_indices.emplace(model.frames[k].name, k);
+  }
 }
 
 pinocchio::FrameIndex RobotWrapper::get_frame_index(const std::string& frame)
 {
-  if (!model.existFrame(frame))
+  auto it = frame_indices.find(frame);
+
+  if (it == frame_indices.end() && model.existFrame(frame))
+  {
+    // The model was modified after loading (e.g frames were added)
+    build_lookups();
+    it = frame_indices.find(frame);
+  }
+
+  if (it == frame_indices.end())
   {
     std::ostringstream oss;
     oss << "Frame with name " << frame << " not found in model";
     throw std::runtime_error(oss.str());
   }
 
-  return model.getFrameId(frame);
+  return it->second;
+}
+
+pinocchio::JointIndex RobotWrapper::get_joint_index(const std::string& joint)
+{
+  auto it = joint_indices.find(joint);
+
+  if (it == joint_indices.end() && model.existJointName(joint))
+  {
+    build_lookups();
+    it = joint_indices.find(joint);
+  }
+
+  if (it == joint_indices.end())
+  {
+    std::ostringstream oss;
+    oss << "Joint with name " << joint << " not found in model";
+    throw std::runtime_error(oss.str());
+  }
+
+  return it->second;
 }
 
 void RobotWrapper::set_joint(const std::string& name, double value)
@@ -150,19 +424,80 @@ double RobotWrapper::get_joint(const std::string& name)
 
 int RobotWrapper::get_joint_offset(const std::string& name)
 {
-  if (!model.existJointName(name))
+  return 7 + get_joint_index(name) - 2;
+}
+
+int RobotWrapper::get_joint_v_offset(const std::string& name)
+{
+  return 6 + get_joint_index(name) - 2;
+}
+
+RobotWrapper::JointSelection RobotWrapper::joint_selection(const std::vector<std::string>& names)
+{
+  JointSelection selection;
+  selection.names = names;
+
+  for (auto& name : names)
+  {
+    selection.q_offsets.push_back(get_joint_offset(name));
+    selection.v_offsets.push_back(get_joint_v_offset(name));
+  }
+
+  return selection;
+}
+
+static void check_selection_size(const RobotWrapper::JointSelection& selection, const Eigen::VectorXd& values)
+{
+  if (values.size() != (int)selection.names.size())
   {
     std::ostringstream oss;
-    oss << "Joint with name " << name << " not found in model";
+    oss << "Expected " << selection.names.size() << " values for the joint selection, got " << values.size();
     throw std::runtime_error(oss.str());
   }
+}
+
+void RobotWrapper::set_joints(const JointSelection& selection, const Eigen::VectorXd& values)
+{
+  check_selection_size(selection, values);
 
-  return 7 + model.getJointId(name) - 2;
+  for (size_t k = 0; k < selection.q_offsets.size(); k++)
+  {
+    state.q[selection.q_offsets[k]] = values[k];
+  }
 }
 
-int RobotWrapper::get_joint_v_offset(const std::string& name)
+Eigen::VectorXd RobotWrapper::get_joints(const JointSelection& selection)
+{
+  Eigen::VectorXd values(selection.q_offsets.size());
+
+  for (size_t k = 0; k < selection.q_offsets.size(); k++)
+  {
+    values[k] = state.q[selection.q_offsets[k]];
+  }
+
+  return values;
+}
+
+void RobotWrapper::set_joint_velocities(const JointSelection& selection, const Eigen::VectorXd& values)
+{
+  check_selection_size(selection, values);
+
+  for (size_t k = 0; k < selection.v_offsets.size(); k++)
+  {
+    state.qd[selection.v_offsets[k]] = values[k];
+  }
+}
+
+Eigen::VectorXd RobotWrapper::get_joint_velocities(const JointSelection& selection)
 {
-  return 6 + model.getJointId(name) - 2;
+  Eigen::VectorXd values(selection.v_offsets.size());
+
+  for (size_t k = 0; k < selection.v_offsets.size(); k++)
+  {
+    values[k] = state.qd[selection.v_offsets[k]];
+  }
+
+  return values;
 }
 
 double RobotWrapper::get_joint_velocity(const std::string& name)
@@ -284,6 +619,7 @@ void RobotWrapper::load_collision_pairs(const std::string& filename)
   }
 
   collision_model.removeAllCollisionPairs();
+  invalidate_collision_data();
 
   std::ifstream f(filename);
   if (!f.is_open())
@@ -334,6 +670,93 @@ void RobotWrapper::load_collision_pairs(const std::string& filename)
   }
 }
 
+int RobotWrapper::prune_collision_pairs(const std::string& filename, int samples, double margin)
+{
+  // Joints without limits are sampled in [-pi, pi], the floating base has no effect on self collisions
+  Eigen::VectorXd lower = model.lowerPositionLimit;
+  Eigen::VectorXd upper = model.upperPositionLimit;
+  for (int k = 0; k < model.nq; k++)
+  {
+    if (std::abs(lower[k]) >= std::numeric_limits<double>::max())
+    {
+      lower[k] = -M_PI;
+    }
+    if (std::abs(upper[k]) >= std::numeric_limits<double>::max())
+    {
+      upper[k] = M_PI;
+    }
+  }
+
+  // Working on separate data, so that the robot state is not affected
+  pinocchio::Data sample_data(model);
+  pinocchio::GeometryData geom_data(collision_model);
+
+  size_t n = collision_model.collisionPairs.size();
+  std::vector<int> collisions(n, 0);
+  std::vector<double> min_distances(n, std::numeric_limits<double>::infinity());
+
+  for (int sample = 0; sample < samples; sample++)
+  {
+    Eigen::VectorXd q = pinocchio::randomConfiguration(model, lower, upper);
+    pinocchio::updateGeometryPlacements(model, sample_data, collision_model, geom_data, q);
+
+    for (size_t k = 0; k < n; k++)
+    {
+      if (pinocchio::computeCollision(collision_model, geom_data, k))
+      {
+        collisions[k] += 1;
+        min_distances[k] = 0;
+      }
+      else if (min_distances[k] >= margin)
+      {
+        const hpp::fcl::DistanceResult& dr = pinocchio::computeDistance(collision_model, geom_data, k);
+        min_distances[k] = std::min(min_distances[k], dr.min_distance);
+      }
+    }
+  }
+
+  // Keeping only the pairs that can come close without being always in collision
+  std::vector<pinocchio::CollisionPair> pairs;
+  for (size_t k = 0; k < n; k++)
+  {
+    if (collisions[k] < samples && min_distances[k] < margin)
+    {
+      pairs.push_back(collision_model.collisionPairs[k]);
+    }
+  }
+
+  collision_model.removeAllCollisionPairs();
+  invalidate_collision_data();
+  for (auto& pair : pairs)
+  {
+    collision_model.addCollisionPair(pair);
+  }
+
+  if (filename != "")
+  {
+    Json::Value json(Json::arrayValue);
+
+    for (auto& pair : pairs)
+    {
+      Json::Value entry(Json::arrayValue);
+      entry.append((int)pair.first);
+      entry.append((int)pair.second);
+      json.append(entry);
+    }
+
+    std::ofstream f(filename);
+    if (!f.is_open())
+    {
+      std::ostringstream oss;
+      oss << "Can't write collision pairs to " << filename;
+      throw std::runtime_error(oss.str());
+    }
+    f << json;
+  }
+
+  return pairs.size();
+}
+
 Eigen::Affine3d RobotWrapper::get_T_world_frame(const std::string& frame)
 {
   return get_T_world_frame(get_frame_index(frame));
@@ -371,7 +794,7 @@ void RobotWrapper::set_T_world_frame(pinocchio::FrameIndex frame, Eigen::Affine3
 std::vector<RobotWrapper::Collision> RobotWrapper::self_collisions(bool stop_at_first)
 {
   std::vector<Collision> collisions;
-  pinocchio::GeometryData geom_data(collision_model);
+  pinocchio::GeometryData& geom_data = get_collision_data();
 
   // And test all the collision pairs
   pinocchio::computeCollisions(model, *data, collision_model, geom_data, state.q);
@@ -411,16 +834,78 @@ std::vector<RobotWrapper::Collision> RobotWrapper::self_collisions(bool stop_at_
 
 std::vector<RobotWrapper::Distance> RobotWrapper::distances()
 {
-  std::vector<Distance> distances;
-  pinocchio::GeometryData geom_data(collision_model);
+  std::vector<Distance> result;
+  distances(result);
 
-  // And test all the collision pairs
-  pinocchio::computeDistances(model, *data, collision_model, geom_data, state.q);
+  return result;
+}
+
+void RobotWrapper::distances(std::vector<Distance>& distances, double max_distance)
+{
+  pinocchio::GeometryData& geom_data = get_collision_data();
+
+  // Updating the placements of all the collision objects
+  pinocchio::updateGeometryPlacements(model, *data, collision_model, geom_data, state.q);
+
+  // Bounding the motion of each collision object since the previous call. For any point p of a bounding sphere
+  // of center c and radius r, we have |T p - T' p| <= |T c - T' c| + |R - R'| r
+  if (previous_placements.size() != geom_data.oMg.size())
+  {
+    previous_placements.assign(geom_data.oMg.begin(), geom_data.oMg.end());
+  }
+
+  for (size_t k = 0; k < geom_data.oMg.size(); k++)
+  {
+    const pinocchio::SE3& placement = geom_data.oMg[k];
+    const pinocchio::SE3& previous = previous_placements[k];
+    const BoundingSphere& sphere = bounding_spheres[k];
+
+    double rotation_motion = (placement.rotation() - previous.rotation()).norm();
+    motion_bounds[k] = (placement.act(sphere.center) - previous.act(sphere.center)).norm();
+    if (rotation_motion > 0)
+    {
+      motion_bounds[k] += rotation_motion * sphere.radius;
+    }
+
+    previous_placements[k] = placement;
+  }
+
+  distances.clear();
 
   for (size_t k = 0; k < collision_model.collisionPairs.size(); ++k)
   {
     const pinocchio::CollisionPair& cp = collision_model.collisionPairs[k];
-    const hpp::fcl::DistanceResult& dr = geom_data.distanceResults[k];
+
+    // Temporal coherence: the distance can't have decreased more than the motion of both objects
+    double& lower_bound = distance_lower_bounds[k];
+    lower_bound -= motion_bounds[cp.first] + motion_bounds[cp.second];
+
+    if (lower_bound >= max_distance)
+    {
+      continue;
+    }
+
+    // Broad phase: the distance between bounding spheres is a lower bound of the distance between the objects
+    const BoundingSphere& sphereA = bounding_spheres[cp.first];
+    const BoundingSphere& sphereB = bounding_spheres[cp.second];
+    Eigen::Vector3d centerA = geom_data.oMg[cp.first].act(sphereA.center);
+    Eigen::Vector3d centerB = geom_data.oMg[cp.second].act(sphereB.center);
+    double spheres_distance = (centerB - centerA).norm() - sphereA.radius - sphereB.radius;
+
+    if (spheres_distance >= max_distance)
+    {
+      lower_bound = spheres_distance;
+      continue;
+    }
+
+    // Narrow phase
+    const hpp::fcl::DistanceResult& dr = pinocchio::computeDistance(collision_model, geom_data, k);
+    lower_bound = dr.min_distance;
+
+    if (dr.min_distance >= max_distance)
+    {
+      continue;
+    }
 
     Distance distance;
     distance.objA = cp.first;
@@ -432,8 +917,64 @@ std::vector<RobotWrapper::Distance> RobotWrapper::distances()
     distance.parentB = collision_model.geometryObjects[cp.second].parentJoint;
     distances.push_back(distance);
   }
+}
+
+// Hash of the collision pairs and of the geometries, so that changes made directly on the (public) collision model
+// are detected
+static size_t collision_model_hash(const pinocchio::GeometryModel& collision_model)
+{
+  size_t hash = collision_model.geometryObjects.size();
+  auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+  for (auto& object : collision_model.geometryObjects)
+  {
+    combine(std::hash<const void*>()(object.geometry.get()));
+  }
+  for (auto& pair : collision_model.collisionPairs)
+  {
+    combine(pair.first);
+    combine(pair.second);
+  }
+
+  return hash;
+}
+
+void RobotWrapper::invalidate_collision_data()
+{
+  collision_data.reset();
+  bounding_spheres.clear();
+  previous_placements.clear();
+  motion_bounds.clear();
+  distance_lower_bounds.clear();
+}
+
+pinocchio::GeometryData& RobotWrapper::get_collision_data()
+{
+  // The FCL requests, results and functors are created per collision pair, and the distance caches per pair and
+  // geometry, they have to be rebuilt if the collision model changed
+  size_t hash = collision_model_hash(collision_model);
+  if (collision_data != nullptr && hash == collision_data_hash)
+  {
+    return *collision_data;
+  }
+
+  invalidate_collision_data();
+  collision_data = std::make_shared<pinocchio::GeometryData>(collision_model);
+  collision_data_hash = hash;
+  distance_lower_bounds.assign(collision_model.collisionPairs.size(), -std::numeric_limits<double>::infinity());
+  bounding_spheres.resize(collision_model.geometryObjects.size());
+  motion_bounds.resize(collision_model.geometryObjects.size());
+
+  for (size_t k = 0; k < collision_model.geometryObjects.size(); k++)
+  {
+    // Unbounded geometries (e.g planes) will have an infinite radius, and will never be culled
+    auto& geometry = collision_model.geometryObjects[k].geometry;
+    geometry->computeLocalAABB();
+    bounding_spheres[k].center = geometry->aabb_center;
+    bounding_spheres[k].radius = geometry->aabb_radius;
+  }
 
-  return distances;
+  return *collision_data;
 }
 
 static pinocchio::ReferenceFrame string_to_reference(const std::string& reference)
@@ -489,7 +1030,7 @@ Eigen::MatrixXd RobotWrapper::frame_jacobian_time_variation(pinocchio::FrameInde
 
 Eigen::MatrixXd RobotWrapper::joint_jacobian(const std::string& joint, const std::string& reference)
 {
-  return joint_jacobian(model.getJointId(joint), string_to_reference(reference));
+  return joint_jacobian(get_joint_index(joint), string_to_reference(reference));
 }
 
 Eigen::MatrixXd RobotWrapper::joint_jacobian(pinocchio::JointIndex joint, pinocchio::ReferenceFrame ref)
@@ -503,7 +1044,7 @@ Eigen::MatrixXd RobotWrapper::joint_jacobian(pinocchio::JointIndex joint, pinocc
 
 Eigen::MatrixXd RobotWrapper::joint_jacobian_time_variation(const std::string& joint, const std::string& reference)
 {
-  return joint_jacobian(model.getJointId(joint), string_to_reference(reference));
+  return joint_jacobian_time_variation(get_joint_index(joint), string_to_reference(reference));
 }
 
 Eigen::MatrixXd RobotWrapper::joint_jacobian_time_variation(pinocchio::JointIndex joint, pinocchio::ReferenceFrame ref)
@@ -599,8 +1140,9 @@ void RobotWrapper::integrate(double dt)
     state.qd = state.qd + dt * state.qdd;
   }
 
-  // Integrate velocity
-  state.q = pinocchio::integrate(model, state.q, state.qd * dt);
+  // Integrate velocity (copying the result to keep state.q storage, see reset())
+  Eigen::VectorXd q = pinocchio::integrate(model, state.q, state.qd * dt);
+  state.q = q;
 }
 
 Eigen::VectorXd RobotWrapper::static_gravity_compensation_torques(RobotWrapper::FrameIndex frameIndex)
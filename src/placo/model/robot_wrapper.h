@@ -5,6 +5,10 @@
 #include "pinocchio/algorithm/kinematics.hpp"
 #include "pinocchio/parsers/urdf.hpp"
 #include <pinocchio/container/boost-container-limits.hpp>
+#include <hpp/fcl/data_types.h>
+#include <memory>
+#include <unordered_map>
+#include <limits>
 
 namespace placo::model
 {
@@ -29,7 +33,27 @@ public:
     /**
      * @brief All self-collisions will be ignored (the pairs will be removed)
      */
-    IGNORE_COLLISIONS = 2
+    IGNORE_COLLISIONS = 2,
+
+    /**
+     * @brief Collision meshes are replaced with their convex hulls, making distance queries significantly faster
+     * (GJK on small convex shapes instead of triangle meshes). The hulls are cached next to the URDF file
+     * (``.convex`` suffix), so that they are only computed once.
+     */
+    CONVEX_COLLISIONS = 4,
+
+    /**
+     * @brief The parsed models (kinematics, collision and visual geometries, collision pairs) are cached in a
+     * binary form next to the URDF file, so that later loadings skip the URDF parsing and the meshes loading (see
+     * \ref ModelCache)
+     */
+    MODEL_CACHE = 8,
+
+    /**
+     * @brief The visual geometry is only loaded when it is first requested through \ref get_visual_model (e.g
+     * by the visualization), reducing loading time and memory usage when no visualization is needed
+     */
+    LAZY_VISUAL = 16
   };
 
   /**
@@ -42,6 +66,23 @@ public:
    */
   RobotWrapper(std::string model_directory, int flags = 0, std::string urdf_content = "");
 
+  /**
+   * @brief Creates a robot wrapper sharing the geometries of another one, without parsing the URDF again.
+   *
+   * The collision and visual geometries (meshes) are reference-counted and shared between the instances, while
+   * the (lightweight) kinematic model, the \ref state, the pinocchio data and the collision data are owned by each
+   * instance. This is the preferred way to create many robots from the same URDF.
+   *
+   * @param other robot wrapper to share the geometries with
+   */
+  RobotWrapper(const RobotWrapper& other);
+
+  /**
+   * @brief Assigns another robot wrapper, with the same sharing as the copy constructor
+   * @param other robot wrapper to share the geometries with
+   */
+  RobotWrapper& operator=(const RobotWrapper& other);
+
   /**
    * @brief Represents the robot state
    *
@@ -75,6 +116,11 @@ public:
    */
   typedef pinocchio::FrameIndex FrameIndex;
 
+  /**
+   * @brief The index of a joint (currently directly wrapped to pinocchio's JointIndex)
+   */
+  typedef pinocchio::JointIndex JointIndex;
+
   /**
    * @brief Loads collision pairs from a given JSON file.
    *
@@ -96,6 +142,21 @@ public:
    */
   void load_collision_pairs(const std::string& filename);
 
+  /**
+   * @brief Prunes the collision pairs by sampling random configurations within the joint limits.
+   *
+   * Pairs that are colliding in all the samples (e.g adjacent links) and pairs that never come closer than
+   * ``margin`` are removed from the collision model. If ``filename`` is not empty, the remaining pairs are written
+   * to this file, using the format of \ref load_collision_pairs (typically ``collisions.json`` next to the URDF, so
+   * that the analysis is done once offline).
+   *
+   * @param filename path to the collisions.json file to write (nothing is written if empty)
+   * @param samples number of random configurations to sample
+   * @param margin pairs that never come closer than this distance are removed [m]
+   * @return the number of collision pairs kept
+   */
+  int prune_collision_pairs(const std::string& filename = "", int samples = 1000, double margin = 0.01);
+
   /**
    * @brief Reset internal states, this sets q to the neutral position, qd and qdd to zero
    *
@@ -111,6 +172,14 @@ public:
    */
   FrameIndex get_frame_index(const std::string& frame);
 
+  /**
+   * @brief Retrieves a joint index from its name. This is useful to speed-up later calls to methods requiring
+   * joints (e.g \ref joint_jacobian)
+   * @param joint joint name
+   * @return joint index
+   */
+  JointIndex get_joint_index(const std::string& joint);
+
   /**
    * @brief Sets the value of a joint in state.q
    * @param name joint name
@@ -154,7 +223,8 @@ public:
   double get_joint_acceleration(const std::string& name);
 
   /**
-   * @brief Gets the offset for a given joint in the \ref state (in \ref State.q)
+   * @brief Gets the offset for a given joint in the \ref state (in \ref State.q). The offset can be stored to
+   * avoid the name lookup in hot loops
    * @param name joint name
    * @return offset in state.q
    */
@@ -167,6 +237,63 @@ public:
    */
   int get_joint_v_offset(const std::string& name);
 
+  /**
+   * @brief A selection of joints, resolved once to their offsets in the \ref state. It is used to read or write
+   * several joints in a single call (see \ref set_joints and \ref get_joints)
+   */
+  struct JointSelection
+  {
+    /**
+     * @brief Names of the selected joints
+     */
+    std::vector<std::string> names;
+
+    /**
+     * @brief Offsets of the selected joints in state.q
+     */
+    std::vector<int> q_offsets;
+
+    /**
+     * @brief Offsets of the selected joints in state.qd and state.qdd
+     */
+    std::vector<int> v_offsets;
+  };
+
+  /**
+   * @brief Creates a joint selection from joint names
+   * @param names joint names
+   * @return joint selection
+   */
+  JointSelection joint_selection(const std::vector<std::string>& names);
+
+  /**
+   * @brief Sets the values of selected joints in state.q
+   * @param selection joint selection (see \ref joint_selection)
+   * @param values joint values, in the order of the selection
+   */
+  void set_joints(const JointSelection& selection, const Eigen::VectorXd& values);
+
+  /**
+   * @brief Retrieves the values of selected joints from state.q
+   * @param selection joint selection (see \ref joint_selection)
+   * @return joint values, in the order of the selection
+   */
+  Eigen::VectorXd get_joints(const JointSelection& selection);
+
+  /**
+   * @brief Sets the velocities of selected joints in state.qd
+   * @param selection joint selection (see \ref joint_selection)
+   * @param values joint velocities, in the order of the selection
+   */
+  void set_joint_velocities(const JointSelection& selection, const Eigen::VectorXd& values);
+
+  /**
+   * @brief Retrieves the velocities of selected joints from state.qd
+   * @param selection joint selection (see \ref joint_selection)
+   * @return joint velocities, in the order of the selection
+   */
+  Eigen::VectorXd get_joint_velocities(const JointSelection& selection);
+
   /**
    * @brief Sets the limits for a given joint.
    *
@@ -408,6 +535,21 @@ public:
    */
   std::vector<Distance> distances();
 
+  /**
+   * @brief Computes minimum distances between current collision pairs, filling the given buffer
+   *
+   * Passing the same vector across calls avoids any allocation in the control loop.
+   *
+   * If ``max_distance`` is provided, only the pairs closer than this distance are reported. The exact distance
+   * computation is then skipped for pairs that are provably farther, either because their bounding spheres are
+   * farther, or because their last computed distance minus the motion of both objects since is still greater.
+   *
+   * @param distances output buffer of \ref Distance
+   * @param max_distance pairs farther than this distance are not reported [m]
+   * @pyignore
+   */
+  void distances(std::vector<Distance>& distances, double max_distance = std::numeric_limits<double>::infinity());
+
   /**
    * @brief Frame jacobian, default reference is LOCAL_WORLD_ALIGNED
    *
@@ -636,16 +778,127 @@ public:
   pinocchio::GeometryModel collision_model;
 
   /**
-   * @brief Pinocchio visual model
+   * @brief Pinocchio visual model. If the \ref LAZY_VISUAL flag is used, it is empty until \ref get_visual_model
+   * is called
    */
   pinocchio::GeometryModel visual_model;
 
   /**
-   * @brief Pinocchio model data
+   * @brief Gets the visual model, loading it first if needed (see \ref LAZY_VISUAL)
+   * @return pinocchio visual model
+   */
+  pinocchio::GeometryModel& get_visual_model();
+
+  /**
+   * @brief Pinocchio model data, owned by this instance
    */
-  pinocchio::Data* data;
+  std::unique_ptr<pinocchio::Data> data;
+
+  /**
+   * @brief Pinocchio collision data (FCL requests and results), kept across \ref distances and
+   * \ref self_collisions calls
+   */
+  std::shared_ptr<pinocchio::GeometryData> collision_data;
 
 protected:
+  /**
+   * @brief Flags passed to the constructor (see \ref Flags)
+   */
+  int flags;
+
+  /**
+   * @brief URDF file, content (if it was passed to the constructor) and mesh directory, kept to load the visual
+   * model lazily
+   */
+  std::string urdf_filename;
+  std::string urdf_content;
+  std::string mesh_directory;
+
+  /**
+   * @brief Look-up tables from names to joint and frame indices, built once the model is loaded (pinocchio's
+   * getJointId and getFrameId are linear searches)
+   */
+  std::unordered_map<std::string, JointIndex> joint_indices;
+  std::unordered_map<std::string, FrameIndex> frame_indices;
+
+  /**
+   * @brief Builds \ref joint_indices and \ref frame_indices
+   */
+  void build_lookups();
+
+  /**
+   * @brief Whether \ref visual_model was loaded
+   */
+  bool visual_model_loaded = false;
+
+  /**
+   * @brief Loads the visual model from the URDF
+   */
+  void load_visual_model();
+
+  /**
+   * @brief Replaces the collision meshes with their convex hulls (see \ref CONVEX_COLLISIONS)
+   * @param cache_filename file where the hulls are cached (no cache is used if empty)
+   */
+  void make_collisions_convex(const std::string& cache_filename);
+
+  /**
+   * @brief Loads the convex hulls vertices from the cache, if it is valid
+   * @param cache_filename cache file
+   * @param hulls vertices of the hull of each collision object (empty for non-mesh objects)
+   * @return true if the cache was loaded
+   */
+  bool load_convex_cache(const std::string& cache_filename, std::vector<std::vector<hpp::fcl::Vec3f>>& hulls);
+
+  /**
+   * @brief Ensures \ref collision_data matches the current collision model, rebuilding it (and the distance
+   * caches) if the pairs or the geometries changed
+   * @return collision data
+   */
+  pinocchio::GeometryData& get_collision_data();
+
+  /**
+   * @brief Drops \ref collision_data and the caches built on top of it, to be called when the collision model is
+   * modified
+   */
+  void invalidate_collision_data();
+
+  /**
+   * @brief Hash of the collision pairs and geometries \ref collision_data was built for
+   */
+  size_t collision_data_hash = 0;
+
+  /**
+   * @brief A sphere enclosing a collision object, expressed in the object frame
+   */
+  struct BoundingSphere
+  {
+    Eigen::Vector3d center;
+    double radius;
+  };
+
+  /**
+   * @brief Bounding spheres of the collision objects (indexed as collision_model.geometryObjects), used as a
+   * broad phase in \ref distances
+   */
+  std::vector<BoundingSphere> bounding_spheres;
+
+  /**
+   * @brief Placements of the collision objects at the previous \ref distances call
+   */
+  std::vector<pinocchio::SE3> previous_placements;
+
+  /**
+   * @brief Upper bound of the displacement of each collision object since the previous \ref distances call
+   */
+  std::vector<double> motion_bounds;
+
+  /**
+   * @brief Lower bound of the distance for each collision pair, maintained across \ref distances calls so that
+   * pairs that can't have entered the queried distance are not recomputed (temporal coherence)
+   */
+  std::vector<double> distance_lower_bounds;
+
   /**
    * @brief Free flyer joint
    */
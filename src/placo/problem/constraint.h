@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <Eigen/Dense>
 #include "placo/problem/expression.h"
 
@@ -68,6 +69,12 @@ public:
    */
   bool is_active = false;
 
+  /**
+   * @brief Rows of a hard inequality constraint that are active in the optimal solution, set by the solver. Before
+   * solving, it can be filled with a guess of the active rows (see \ref Problem::warm_start)
+   */
+  std::vector<int> active_rows;
+
   /**
    * @brief Configures the constraint
    * @param priority_ priority
@@ -8,10 +8,26 @@ namespace placo::problem
 {
 double Integrator::Trajectory::value(double t, int diff)
 {
-  t -= t_start;
+  Integrator::check_diff(order, diff);
+
+  return evaluate(t - t_start, diff);
+}
 
+Eigen::VectorXd Integrator::Trajectory::values(const Eigen::VectorXd& ts, int diff)
+{
   Integrator::check_diff(order, diff);
 
+  Eigen::VectorXd result(ts.size());
+  for (int i = 0; i < ts.size(); i++)
+  {
+    result[i] = evaluate(ts[i] - t_start, diff);
+  }
+
+  return result;
+}
+
+double Integrator::Trajectory::evaluate(double t, int diff)
+{
   int k = std::floor(t / dt);
 
   if (k < 0)
@@ -26,13 +42,27 @@ double Integrator::Trajectory::value(double t, int diff)
   {
     return variable_value[k];
   }
+  else if (chain)
+  {
+    // For a chain of integrators, the transition is the Taylor expansion of the state:
+    // x_diff(t) = sum_j x_{diff+j} t^j / j! + u t^(order-diff) / (order-diff)!
+    double result = 0.;
+    double factor = 1.;
+    for (int j = 0; diff + j < order; j++)
+    {
+      result += keyframes(diff + j, k) * factor;
+      factor *= remaining_dt / (j + 1);
+    }
+
+    return result + variable_value[k] * factor;
+  }
   else
   {
     auto AB = AB_matrices(M, order, remaining_dt);
     Eigen::MatrixXd Ar = AB.first;
     Eigen::MatrixXd Br = AB.second;
 
-    Eigen::VectorXd result = Ar * keyframes[k] + Br * variable_value[k];
+    Eigen::VectorXd result = Ar * keyframes.col(k) + Br * variable_value[k];
 
     return result[diff];
   }
@@ -40,7 +70,7 @@ double Integrator::Trajectory::value(double t, int diff)
 
 double Integrator::Trajectory::duration()
 {
-  return keyframes.size() * dt;
+  return keyframes.cols() * dt;
 }
 
 Integrator::Integrator()
@@ -51,6 +81,7 @@ Integrator::Integrator(Variable& variable_, Expression X0, Eigen::MatrixXd syste
   : variable(&variable_), X0(X0), dt(dt), M(system_matrix)
 {
   order = system_matrix.rows() - 1;
+  chain = (M == upper_shift_matrix(order));
 
   N = variable->size();
 
@@ -224,17 +255,17 @@ void Integrator::update_trajectory()
     trajectory.M = M;
     trajectory.dt = dt;
     trajectory.order = order;
+    trajectory.chain = chain;
     trajectory.t_start = t_start;
     trajectory.variable_value = variable->value;
 
     // Updating keyframes
-    Eigen::VectorXd X = X0.value(variable->problem->x);
-    trajectory.keyframes[0] = X;
+    trajectory.keyframes.resize(order, variable->size() + 1);
+    trajectory.keyframes.col(0) = X0.value(variable->problem->x);
 
     for (int k = 1; k <= variable->size(); k++)
     {
-      X = A * X + B * variable->value[k - 1];
-      trajectory.keyframes[k] = X;
+      trajectory.keyframes.col(k) = A * trajectory.keyframes.col(k - 1) + B * variable->value[k - 1];
     }
 
     version = variable->version;
@@ -28,6 +28,14 @@ public:
      */
     double value(double t, int diff);
 
+    /**
+     * @brief Gets the values of the trajectory at many times at once
+     * @param ts times
+     * @param diff differentiation
+     * @return the values
+     */
+    Eigen::VectorXd values(const Eigen::VectorXd& ts, int diff);
+
     /**
      * @brief A copy of the variable value after solve
      */
@@ -39,9 +47,15 @@ public:
     Eigen::MatrixXd M;
 
     /**
-     * @brief Keyframes of the trajectory for each step
+     * @brief Keyframes of the trajectory, one column per step
+     */
+    Eigen::MatrixXd keyframes;
+
+    /**
+     * @brief True if M is the chain integrator (see \ref upper_shift_matrix), in which case the transition is
+     * evaluated in closed form instead of using a matrix exponential
      */
-    std::map<int, Eigen::VectorXd> keyframes;
+    bool chain = false;
 
     /**
      * @brief Trajectory duration
@@ -63,6 +77,12 @@ public:
      * @brief time offset
      */
     double t_start = 0.;
+
+  protected:
+    /**
+     * @brief Evaluates the trajectory at a given (offset) time, without checking diff
+     */
+    double evaluate(double t, int diff);
   };
 
   Integrator();
@@ -190,6 +210,11 @@ public:
    */
   int order;
 
+  /**
+   * @brief True if M is the chain integrator (see \ref upper_shift_matrix)
+   */
+  bool chain = false;
+
   /**
    * @brief Integrator time step duration
    */
@@ -3,17 +3,10 @@
 
 namespace placo::problem
 {
-problem::ProblemConstraint PolygonConstraint::in_polygon_xy(const Expression& expression_xy,
-                                                            std::vector<Eigen::Vector2d> polygon, double margin)
+PolygonConstraint::HalfPlanes::HalfPlanes(const std::vector<Eigen::Vector2d>& polygon, double margin)
 {
-  if (expression_xy.rows() != 2)
-  {
-    throw std::runtime_error("add_polygon_constraint should be called with a 2 rows expressions");
-  }
-
-  problem::Expression values;
-  values.A.resize(polygon.size(), expression_xy.cols());
-  values.b.resize(polygon.size());
+  normals.resize(polygon.size(), 2);
+  offsets.resize(polygon.size());
 
   for (size_t i = 0; i < polygon.size(); i++)
   {
@@ -29,14 +22,75 @@ problem::ProblemConstraint PolygonConstraint::in_polygon_xy(const Expression& ex
     n.normalize();
 
     // The distance to the line is given by n.T * (P - A) >= margin
-    problem::Expression value = (n.transpose() * (expression_xy - A)) - margin;
-    values.A.block(i, 0, 1, expression_xy.cols()) = value.A;
-    values.b(i) = value.b(0);
+    normals.row(i) = n.transpose();
+    offsets(i) = n.dot(A) + margin;
+  }
+}
+
+PolygonConstraint::HalfPlanes::HalfPlanes(const tools::Polygon2d& polygon, double margin)
+{
+  tools::Polygon2d::Normals polygon_normals;
+  tools::Polygon2d::Offsets polygon_offsets;
+  polygon.half_planes(polygon_normals, polygon_offsets);
+
+  normals = polygon_normals.topRows(polygon.size());
+  offsets = polygon_offsets.head(polygon.size()).array() + margin;
+}
+
+problem::ProblemConstraint PolygonConstraint::HalfPlanes::apply(const Expression& expression_xy) const
+{
+  if (expression_xy.rows() != 2)
+  {
+    throw std::runtime_error("add_polygon_constraint should be called with a 2 rows expressions");
+  }
+
+  problem::Expression values;
+  values.A = normals * expression_xy.A;
+  values.b = normals * expression_xy.b - offsets;
+
+  return values >= 0;
+}
+
+problem::ProblemConstraint PolygonConstraint::HalfPlanes::apply(const std::vector<Expression>& expressions_xy) const
+{
+  int cols = 0;
+  for (auto& expression_xy : expressions_xy)
+  {
+    if (expression_xy.rows() != 2)
+    {
+      throw std::runtime_error("add_polygon_constraint should be called with a 2 rows expressions");
+    }
+    cols = std::max(cols, expression_xy.cols());
+  }
+
+  // One block of rows per expression
+  int n = normals.rows();
+  problem::Expression values;
+  values.A = Eigen::MatrixXd::Zero(n * expressions_xy.size(), cols);
+  values.b.resize(n * expressions_xy.size());
+
+  for (size_t k = 0; k < expressions_xy.size(); k++)
+  {
+    const Expression& expression_xy = expressions_xy[k];
+    values.A.block(k * n, 0, n, expression_xy.cols()) = normals * expression_xy.A;
+    values.b.segment(k * n, n) = normals * expression_xy.b - offsets;
   }
 
   return values >= 0;
 }
 
+problem::ProblemConstraint PolygonConstraint::in_polygon_xy(const Expression& expression_xy,
+                                                            std::vector<Eigen::Vector2d> polygon, double margin)
+{
+  return HalfPlanes(polygon, margin).apply(expression_xy);
+}
+
+problem::ProblemConstraint PolygonConstraint::in_polygon_xy(const Expression& expression_xy,
+                                                            const tools::Polygon2d& polygon, double margin)
+{
+  return HalfPlanes(polygon, margin).apply(expression_xy);
+}
+
 problem::ProblemConstraint PolygonConstraint::in_polygon(const Expression& expression_x, const Expression& expression_y,
                                                          std::vector<Eigen::Vector2d> polygon, double margin)
 {
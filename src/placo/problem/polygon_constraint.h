@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "placo/problem/problem.h"
+#include "placo/tools/polygon_2d.h"
 
 namespace placo::problem
 {
@@ -11,6 +12,38 @@ namespace placo::problem
 class PolygonConstraint
 {
 public:
+  /**
+   * @brief Half-planes of a (clockwise) polygon, computed once and then applied to as many 2D expressions as needed
+   * (typically, the ZMP at all the timesteps of a support)
+   */
+  struct HalfPlanes
+  {
+    HalfPlanes(const std::vector<Eigen::Vector2d>& polygon, double margin = 0.);
+    HalfPlanes(const tools::Polygon2d& polygon, double margin = 0.);
+
+    /**
+     * @brief Unit normals of the edges (one per row), pointing inside the polygon
+     */
+    Eigen::MatrixXd normals;
+
+    /**
+     * @brief A point p is in the polygon (with margin) if normals * p >= offsets
+     */
+    Eigen::VectorXd offsets;
+
+    /**
+     * @brief Produces the inequalities so that the given point lies inside the polygon
+     * @param expression_xy 2 rows expression
+     */
+    ProblemConstraint apply(const Expression& expression_xy) const;
+
+    /**
+     * @brief Produces one stacked block of inequalities so that all the given points lie inside the polygon
+     * @param expressions_xy 2 rows expressions
+     */
+    ProblemConstraint apply(const std::vector<Expression>& expressions_xy) const;
+  };
+
   /**
    * @brief Given a polygon, produces inequalities so that the given point lies inside the polygon.
    * WARNING: Polygon must be clockwise (meaning that the exterior of the shape is on the trigonometric normal of
@@ -29,6 +62,12 @@ public:
   static ProblemConstraint in_polygon_xy(const Expression& expression_xy, std::vector<Eigen::Vector2d> polygon,
                                          double margin = 0.);
 
+  /**
+   * @brief Same as \ref in_polygon_xy, for a (clockwise) fixed capacity polygon
+   */
+  static ProblemConstraint in_polygon_xy(const Expression& expression_xy, const tools::Polygon2d& polygon,
+                                         double margin = 0.);
+
   /**
    * See \ref in_polygon_xy
    */
@@ -260,11 +260,14 @@ void Problem::solve()
   h.setZero();
 
   // Used to keep track of the hard/soft inequalities constraints
-  // The hard mapping maps index from inequality row to constraint, and the soft
+  // The hard mapping maps index from inequality row to constraint (and row in this constraint), and the soft
   // mapping maps index from slack variables to the constraint.
-  std::map<int, ProblemConstraint*> hard_inequalities_mapping;
+  std::map<int, std::pair<ProblemConstraint*, int>> hard_inequalities_mapping;
   std::map<int, ProblemConstraint*> soft_inequalities_mapping;
 
+  // Guessed active inequality rows, see warm_start
+  std::vector<int> active_set_guess;
+
   int k_inequality = 0;
   int k_slack = 0;
 
@@ -292,8 +295,21 @@ void Problem::solve()
 
         for (int k = k_inequality; k < k_inequality + expression_A.rows(); k++)
         {
-          hard_inequalities_mapping[k] = constraint;
+          hard_inequalities_mapping[k] = std::make_pair(constraint, k - k_inequality);
+        }
+
+        if (warm_start)
+        {
+          for (int row : constraint->active_rows)
+          {
+            if (row >= 0 && row < expression_A.rows())
+            {
+              active_set_guess.push_back(k_inequality + row);
+            }
+          }
         }
+        constraint->active_rows.clear();
+
         k_inequality += expression_A.rows();
       }
       else
@@ -318,12 +334,26 @@ void Problem::solve()
   }
 
   Eigen::VectorXi active_set;
-  size_t active_set_size;
+  size_t active_set_size = 0;
 
   Eigen::VectorXd qp_x(free_variables + slack_variables);
   qp_x.setZero();
-  double result =
-      eiquadprog::solvers::solve_quadprog(P, q, A.transpose(), b, G.transpose(), h, qp_x, active_set, active_set_size);
+  double result = 0.;
+
+  // Trying the guessed active set before calling the solver, that can't be warm started
+  warm_started = warm_start && active_set_guess.size() > 0 && slack_variables == 0 && A.rows() == 0 &&
+                 solve_active_set(P, q, G, h, active_set_guess, qp_x);
+
+  if (warm_started)
+  {
+    active_set = Eigen::Map<Eigen::VectorXi>(active_set_guess.data(), active_set_guess.size());
+    active_set_size = active_set_guess.size();
+  }
+  else
+  {
+    result = eiquadprog::solvers::solve_quadprog(P, q, A.transpose(), b, G.transpose(), h, qp_x, active_set,
+                                                 active_set_size);
+  }
 
   if (determined_variables)
   {
@@ -371,7 +401,9 @@ void Problem::solve()
 
     if (active_constraint >= 0 && hard_inequalities_mapping.count(active_constraint))
     {
-      hard_inequalities_mapping[active_constraint]->is_active = true;
+      auto& mapping = hard_inequalities_mapping[active_constraint];
+      mapping.first->is_active = true;
+      mapping.first->active_rows.push_back(mapping.second);
     }
   }
 
@@ -392,6 +424,47 @@ void Problem::solve()
   }
 }
 
+bool Problem::solve_active_set(const Eigen::MatrixXd& P, const Eigen::VectorXd& q, const Eigen::MatrixXd& G,
+                               const Eigen::VectorXd& h, const std::vector<int>& guess, Eigen::VectorXd& x)
+{
+  Eigen::LLT<Eigen::MatrixXd> llt(P);
+  if (llt.info() != Eigen::Success)
+  {
+    return false;
+  }
+
+  Eigen::MatrixXd G_active(guess.size(), G.cols());
+  Eigen::VectorXd h_active(guess.size());
+  for (size_t k = 0; k < guess.size(); k++)
+  {
+    G_active.row(k) = G.row(guess[k]);
+    h_active[k] = h[guess[k]];
+  }
+
+  // With the guessed rows active, x = x0 + P^-1 G_active^T lambda, where x0 is the unconstrained optimum and the
+  // multipliers lambda are such that G_active x + h_active = 0
+  Eigen::VectorXd x0 = -llt.solve(q);
+  Eigen::MatrixXd V = llt.matrixL().solve(G_active.transpose());
+  Eigen::VectorXd lambda = (V.transpose() * V).ldlt().solve(-(G_active * x0 + h_active));
+
+  // The multipliers of the inequalities should be positive
+  if (!lambda.allFinite() || (lambda.size() > 0 && lambda.minCoeff() < -1e-10))
+  {
+    return false;
+  }
+
+  Eigen::VectorXd x_active = x0 + llt.matrixU().solve(V * lambda);
+
+  // The guessed rows should be enforced, and all the other inequalities satisfied
+  if ((G_active * x_active + h_active).cwiseAbs().maxCoeff() > 1e-8 || (G * x_active + h).minCoeff() < -1e-8)
+  {
+    return false;
+  }
+
+  x = x_active;
+  return true;
+}
+
 void Problem::dump_status()
 {
   std::cout << "Problem status:" << std::endl;
@@ -115,6 +115,22 @@ public:
    */
   bool rewrite_equalities = true;
 
+  /**
+   * @brief If set to true, the \ref ProblemConstraint::active_rows of the hard inequality constraints are used as a
+   * guess of the optimal active set. The problem where these rows are equalities is solved first, and its solution
+   * is kept if it fulfills the optimality conditions (all the inequalities are satisfied and all the multipliers are
+   * positive). Otherwise, the QP solver is called as usual.
+   *
+   * This is useful when solving a sequence of similar problems (for instance, in a receding horizon).
+   * It is not used if the problem has soft inequalities.
+   */
+  bool warm_start = false;
+
+  /**
+   * @brief True if the last solution was obtained from the \ref warm_start guess, without calling the QP solver
+   */
+  bool warm_started = false;
+
   void dump_status();
 
 protected:
@@ -146,5 +162,19 @@ protected:
    * @param b output vector b
    */
   void get_constraint_expressions(ProblemConstraint* constraint, Eigen::MatrixXd& A, Eigen::MatrixXd& b);
+
+  /**
+   * @brief Used internally to check a guess of the active set, see \ref warm_start. Solves the problem
+   * min 1/2 x^T P x + q^T x where the guessed rows of Gx + h >= 0 are equalities.
+   * @param P objective matrix
+   * @param q objective vector
+   * @param G inequalities matrix
+   * @param h inequalities vector
+   * @param guess guessed active rows
+   * @param x output solution
+   * @return true if x is the solution of the QP (the guess was right)
+   */
+  bool solve_active_set(const Eigen::MatrixXd& P, const Eigen::VectorXd& q, const Eigen::MatrixXd& G,
+                        const Eigen::VectorXd& h, const std::vector<int>& guess, Eigen::VectorXd& x);
 };
 }  // namespace placo::problem
\ No newline at end of file
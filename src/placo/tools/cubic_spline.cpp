@@ -33,12 +33,31 @@ void CubicSpline::add_point(double t, double x, double dx)
 void CubicSpline::clear()
 {
   _points.clear();
-  _splines.clear();
+  _t_starts.clear();
+  _t_ends.clear();
+  _polynoms.clear();
+}
+
+void CubicSpline::update()
+{
+  if (dirty)
+  {
+    compute_splines();
+    dirty = false;
+  }
 }
 
 double CubicSpline::duration() const
 {
-  return _splines[_splines.size() - 1].t_end - _splines[0].t_start;
+  return _t_ends.back() - _t_starts.front();
+}
+
+size_t CubicSpline::find_spline(double t) const
+{
+  // Binary search on the start times
+  auto it = std::upper_bound(_t_starts.begin(), _t_starts.end(), t);
+
+  return (it == _t_starts.begin()) ? 0 : std::min<size_t>(it - _t_starts.begin() - 1, _t_starts.size() - 1);
 }
 
 /**
@@ -47,11 +66,12 @@ double CubicSpline::duration() const
  */
 double CubicSpline::interpolation(double t, CubicSpline::ValueType type)
 {
-  if (dirty)
-  {
-    compute_splines();
-    dirty = false;
-  }
+  return interpolation(t, type, nullptr);
+}
+
+double CubicSpline::interpolation(double t, CubicSpline::ValueType type, size_t* hint)
+{
+  update();
 
   if (_points.size() == 0)
   {
@@ -68,32 +88,54 @@ double CubicSpline::interpolation(double t, CubicSpline::ValueType type)
       return _points.front().dx;
     }
   }
+  else if (_polynoms.size() == 0)
+  {
+    return 0.0;
+  }
   else
   {
-    if (t < _splines.front().t_start)
+    if (t < _t_starts.front())
     {
-      t = _splines.front().t_start;
+      t = _t_starts.front();
     }
-    if (t > _splines.back().t_end)
+    if (t > _t_ends.back())
     {
-      t = _splines.back().t_end;
+      t = _t_ends.back();
     }
 
-    for (size_t i = 0; i < _splines.size(); i++)
+    size_t i = _t_starts.size();
+
+    if (hint != nullptr)
     {
-      if (t >= _splines[i].t_start && t <= _splines[i].t_end)
+      // Trying the hinted spline and the next one first
+      for (size_t k = *hint; k < std::min(*hint + 2, _t_starts.size()); k++)
       {
-        if (type == Value)
+        if (t >= _t_starts[k] && t <= _t_ends[k])
         {
-          return polynom_value(t - _splines[i].t_start, _splines[i].poly);
-        }
-        else if (type == Speed)
-        {
-          return polynom_diff(t - _splines[i].t_start, _splines[i].poly);
+          i = k;
+          break;
         }
       }
     }
-    return 0.0;
+
+    if (i == _t_starts.size())
+    {
+      i = find_spline(t);
+    }
+
+    if (hint != nullptr)
+    {
+      *hint = i;
+    }
+
+    if (type == Value)
+    {
+      return polynom_value(t - _t_starts[i], _polynoms[i]);
+    }
+    else
+    {
+      return polynom_diff(t - _t_starts[i], _polynoms[i]);
+    }
   }
 }
 
@@ -107,6 +149,30 @@ double CubicSpline::vel(double t)
   return interpolation(t, Speed);
 }
 
+Eigen::VectorXd CubicSpline::pos(const Eigen::VectorXd& ts)
+{
+  Eigen::VectorXd result(ts.size());
+  size_t hint = 0;
+  for (int k = 0; k < ts.size(); k++)
+  {
+    result[k] = interpolation(ts[k], Value, &hint);
+  }
+
+  return result;
+}
+
+Eigen::VectorXd CubicSpline::vel(const Eigen::VectorXd& ts)
+{
+  Eigen::VectorXd result(ts.size());
+  size_t hint = 0;
+  for (int k = 0; k < ts.size(); k++)
+  {
+    result[k] = interpolation(ts[k], Speed, &hint);
+  }
+
+  return result;
+}
+
 /**
  * Access to internal Points container
  */
@@ -125,52 +191,63 @@ double CubicSpline::polynom_diff(double t, const Polynom& p)
   return t * (3 * p.a * t + 2 * p.b) + p.c;
 }
 
-CubicSpline::Polynom CubicSpline::fit(double t1, double x1, double dx1, double t2, double x2, double dx2)
+void CubicSpline::fit_hermite(const Eigen::ArrayXd& durations, const Eigen::ArrayXd& x1, const Eigen::ArrayXd& dx1,
+                              const Eigen::ArrayXd& x2, const Eigen::ArrayXd& dx2, std::vector<Polynom>& polynoms)
 {
-  Eigen::Matrix4d M;
-  double t1_2 = t1 * t1;
-  double t1_3 = t1_2 * t1;
-  double t2_2 = t2 * t2;
-  double t2_3 = t2_2 * t2;
-
-  M << t1_3, t1_2, t1, 1,      //
-      3 * t1_2, 2 * t1, 1, 0,  //
-      t2_3, t2_2, t2, 1,       //
-      3 * t2_2, 2 * t2, 1, 0   //
-      ;
-
-  Eigen::Vector4d v;
-  v << x1, dx1, x2, dx2;
-
-  Eigen::Vector4d abcd = M.inverse() * v;
-
-  struct CubicSpline::Polynom polynom = { abcd[0], abcd[1], abcd[2], abcd[3] };
-
-  return polynom;
+  // With p(t) = a t^3 + b t^2 + c t + d, p(0) = x1, p'(0) = dx1, p(T) = x2 and p'(T) = dx2
+  Eigen::ArrayXd delta = x2 - x1;
+  Eigen::ArrayXd T2 = durations * durations;
+  Eigen::ArrayXd a = (durations * (dx1 + dx2) - 2 * delta) / (T2 * durations);
+  Eigen::ArrayXd b = (3 * delta - durations * (2 * dx1 + dx2)) / T2;
+
+  polynoms.resize(durations.size());
+  for (int i = 0; i < durations.size(); i++)
+  {
+    polynoms[i] = { a[i], b[i], dx1[i], x1[i] };
+  }
 }
 
 void CubicSpline::compute_splines()
 {
-  _splines.clear();
+  _t_starts.clear();
+  _t_ends.clear();
+  _polynoms.clear();
+
   if (_points.size() < 2)
   {
     return;
   }
 
+  // Segments to fit, skipping the ones that are too short
+  std::vector<size_t> segments;
   for (size_t i = 1; i < _points.size(); i++)
   {
-    if (fabs(_points[i - 1].t - _points[i].t) < 0.00001)
+    if (fabs(_points[i - 1].t - _points[i].t) >= 0.00001)
     {
-      continue;
+      segments.push_back(i);
     }
+  }
 
-    double t_start = _points[i - 1].t;
-    struct Spline spline = { fit(_points[i - 1].t - t_start, _points[i - 1].x, _points[i - 1].dx,
-                                 _points[i].t - t_start, _points[i].x, _points[i].dx),
-                             _points[i - 1].t, _points[i].t };
+  Eigen::ArrayXd durations(segments.size()), x1(segments.size()), dx1(segments.size()), x2(segments.size()),
+      dx2(segments.size());
+  _t_starts.resize(segments.size());
+  _t_ends.resize(segments.size());
 
-    _splines.push_back(spline);
+  for (size_t k = 0; k < segments.size(); k++)
+  {
+    const Point& start = _points[segments[k] - 1];
+    const Point& end = _points[segments[k]];
+
+    _t_starts[k] = start.t;
+    _t_ends[k] = end.t;
+    durations[k] = end.t - start.t;
+    x1[k] = start.x;
+    dx1[k] = start.dx;
+    x2[k] = end.x;
+    dx2[k] = end.dx;
   }
+
+  fit_hermite(durations, x1, dx1, x2, dx2, _polynoms);
 }
 
 }  // namespace placo::tools
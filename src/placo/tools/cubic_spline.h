@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <Eigen/Dense>
 
 namespace placo::tools
 {
@@ -38,6 +39,12 @@ public:
    */
   void clear();
 
+  /**
+   * @brief Fits the splines if points were added since the last fit. This is otherwise done by the next query, it
+   * should then be called before querying the spline from several threads
+   */
+  void update();
+
   /**
    * @brief Retrieve the position at a given time
    * @param t time
@@ -52,6 +59,20 @@ public:
    */
   double vel(double x);
 
+  /**
+   * @brief Retrieve the positions at many times at once (faster when times are increasing)
+   * @param ts times
+   * @return positions
+   */
+  Eigen::VectorXd pos(const Eigen::VectorXd& ts);
+
+  /**
+   * @brief Retrieve the velocities at many times at once (faster when times are increasing)
+   * @param ts times
+   * @return velocities
+   */
+  Eigen::VectorXd vel(const Eigen::VectorXd& ts);
+
   enum ValueType
   {
     Value,
@@ -77,24 +98,28 @@ private:
     double d;
   };
 
-  struct Spline
-  {
-    Polynom poly;
-    double t_start;
-    double t_end;
-  };
-
-  typedef std::vector<Spline> Splines;
-
   /**
    * Spline Points container
    */
   Points _points;
 
   /**
-   * Splines container
+   * Splines container (structure of arrays, so that the start times are contiguous for the search)
+   */
+  std::vector<double> _t_starts;
+  std::vector<double> _t_ends;
+  std::vector<Polynom> _polynoms;
+
+  /**
+   * Finds the index of the spline containing t (t being clamped to the spline range)
+   */
+  size_t find_spline(double t) const;
+
+  /**
+   * Spline interpolation. If hint is not null, the spline it points to and the next one are checked before searching
+   * (the time being generally queried monotonically), and it is updated with the spline found
    */
-  Splines _splines;
+  double interpolation(double t, ValueType type, size_t* hint);
 
   /**
    * Fast exponentation to compute
@@ -108,9 +133,10 @@ private:
   static double polynom_diff(double t, const Polynom& p);
 
   /**
-   * Fit a polynom
+   * Fit polynoms starting at t=0 for many segments at once (closed-form Hermite coefficients)
    */
-  static Polynom fit(double t1, double x1, double dx1, double t2, double x2, double dx2);
+  static void fit_hermite(const Eigen::ArrayXd& durations, const Eigen::ArrayXd& x1, const Eigen::ArrayXd& dx1,
+                          const Eigen::ArrayXd& x2, const Eigen::ArrayXd& dx2, std::vector<Polynom>& polynoms);
 
   /**
    * Recompute splines interpolation model
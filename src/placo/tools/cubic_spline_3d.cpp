@@ -13,6 +13,13 @@ void CubicSpline3D::clear()
   zSpline.clear();
 }
 
+void CubicSpline3D::update()
+{
+  xSpline.update();
+  ySpline.update();
+  zSpline.update();
+}
+
 double CubicSpline3D::duration() const
 {
   return xSpline.duration();
@@ -35,4 +42,24 @@ Eigen::Vector3d CubicSpline3D::vel(double t)
   return Eigen::Vector3d(xSpline.vel(t), ySpline.vel(t), zSpline.vel(t));
 }
 
+Eigen::MatrixXd CubicSpline3D::pos(const Eigen::VectorXd& ts)
+{
+  Eigen::MatrixXd result(3, ts.size());
+  result.row(0) = xSpline.pos(ts).transpose();
+  result.row(1) = ySpline.pos(ts).transpose();
+  result.row(2) = zSpline.pos(ts).transpose();
+
+  return result;
+}
+
+Eigen::MatrixXd CubicSpline3D::vel(const Eigen::VectorXd& ts)
+{
+  Eigen::MatrixXd result(3, ts.size());
+  result.row(0) = xSpline.vel(ts).transpose();
+  result.row(1) = ySpline.vel(ts).transpose();
+  result.row(2) = zSpline.vel(ts).transpose();
+
+  return result;
+}
+
 }  // namespace placo::tools
\ No newline at end of file
@@ -23,6 +23,11 @@ public:
    */
   void clear();
 
+  /**
+   * @brief Fits the splines if points were added since the last fit (see CubicSpline::update)
+   */
+  void update();
+
   /**
    * @brief Spline duration
    * @return spline duration in seconds
@@ -43,6 +48,20 @@ public:
    */
   Eigen::Vector3d vel(double t);
 
+  /**
+   * @brief Returns the spline values at many times at once
+   * @param ts times
+   * @return positions (3xK matrix)
+   */
+  Eigen::MatrixXd pos(const Eigen::VectorXd& ts);
+
+  /**
+   * @brief Returns the spline velocities at many times at once
+   * @param ts times
+   * @return velocities (3xK matrix)
+   */
+  Eigen::MatrixXd vel(const Eigen::VectorXd& ts);
+
 private:
   CubicSpline xSpline;
   CubicSpline ySpline;
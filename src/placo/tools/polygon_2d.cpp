@@ -0,0 +1,167 @@
+#include "placo/tools/polygon_2d.h"
+#include <stdexcept>
+
+namespace placo::tools
+{
+Polygon2d::Polygon2d() : n(0)
+{
+}
+
+Polygon2d::Polygon2d(const std::vector<Eigen::Vector2d>& points) : n(0)
+{
+  for (auto& point : points)
+  {
+    push_back(point.x(), point.y());
+  }
+}
+
+void Polygon2d::push_back(double x, double y)
+{
+  if (n >= capacity)
+  {
+    throw std::runtime_error("Polygon2d: too many points");
+  }
+
+  xs[n] = x;
+  ys[n] = y;
+  n += 1;
+}
+
+std::vector<Eigen::Vector2d> Polygon2d::to_vector() const
+{
+  std::vector<Eigen::Vector2d> points;
+
+  for (int i = 0; i < n; i++)
+  {
+    points.push_back(point(i));
+  }
+
+  return points;
+}
+
+Polygon2d Polygon2d::convex_hull() const
+{
+  // Sorting the point indices along x, then y (insertion sort, there are at most capacity points)
+  int order[capacity];
+  for (int i = 0; i < n; i++)
+  {
+    int j = i;
+    while (j > 0 && (xs[order[j - 1]] > xs[i] || (xs[order[j - 1]] == xs[i] && ys[order[j - 1]] > ys[i])))
+    {
+      order[j] = order[j - 1];
+      j -= 1;
+    }
+    order[j] = i;
+  }
+
+  if (n < 3)
+  {
+    Polygon2d hull;
+    for (int i = 0; i < n; i++)
+    {
+      hull.push_back(xs[order[i]], ys[order[i]]);
+    }
+    return hull;
+  }
+
+  // Monotone chain, building the upper hull from left to right, then the lower hull from right to left, keeping
+  // only right turns so that the result is clockwise
+  int hull_indices[2 * capacity];
+  int k = 0;
+
+  auto cross = [&](int o, int a, int b) {
+    return (xs[a] - xs[o]) * (ys[b] - ys[o]) - (ys[a] - ys[o]) * (xs[b] - xs[o]);
+  };
+
+  for (int i = 0; i < n; i++)
+  {
+    while (k >= 2 && cross(hull_indices[k - 2], hull_indices[k - 1], order[i]) >= 0)
+    {
+      k -= 1;
+    }
+    hull_indices[k++] = order[i];
+  }
+
+  for (int i = n - 2, lower_start = k + 1; i >= 0; i--)
+  {
+    while (k >= lower_start && cross(hull_indices[k - 2], hull_indices[k - 1], order[i]) >= 0)
+    {
+      k -= 1;
+    }
+    hull_indices[k++] = order[i];
+  }
+
+  // The last point is the first one
+  Polygon2d hull;
+  for (int i = 0; i < k - 1; i++)
+  {
+    hull.push_back(xs[hull_indices[i]], ys[hull_indices[i]]);
+  }
+
+  return hull;
+}
+
+bool Polygon2d::contains(const Eigen::Vector2d& point, double margin) const
+{
+  Normals normals;
+  Offsets offsets;
+  half_planes(normals, offsets);
+
+  return ((normals.topRows(n) * point - offsets.head(n)).array() >= margin).all();
+}
+
+void Polygon2d::half_planes(Normals& normals, Offsets& offsets) const
+{
+  if (n < 3)
+  {
+    throw std::runtime_error("Polygon2d: half-planes can't be computed with less than 3 points");
+  }
+
+  for (int i = 0; i < n; i++)
+  {
+    int j = (i + 1) % n;
+
+    // Normal pointing inside the polygon (since it is clockwise)
+    Eigen::Vector2d normal(ys[j] - ys[i], xs[i] - xs[j]);
+    double length = normal.norm();
+    if (length < 1e-12)
+    {
+      throw std::runtime_error("Polygon2d: half-planes can't be computed with duplicate consecutive points");
+    }
+    normal /= length;
+
+    normals.row(i) = normal.transpose();
+    offsets[i] = normal.x() * xs[i] + normal.y() * ys[i];
+  }
+}
+
+bool Polygon2d::separated_by_edges(const Polygon2d& other) const
+{
+  for (int i = 0; i < n; i++)
+  {
+    int j = (i + 1) % n;
+    double nx = ys[j] - ys[i];
+    double ny = xs[i] - xs[j];
+
+    auto projections = nx * xs.head(n) + ny * ys.head(n);
+    auto other_projections = nx * other.xs.head(other.n) + ny * other.ys.head(other.n);
+
+    if (projections.maxCoeff() < other_projections.minCoeff() || other_projections.maxCoeff() < projections.minCoeff())
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool Polygon2d::overlap(const Polygon2d& other) const
+{
+  if (n == 0 || other.n == 0)
+  {
+    return false;
+  }
+
+  return !separated_by_edges(other) && !other.separated_by_edges(*this);
+}
+}  // namespace placo::tools
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace placo::tools
+{
+/**
+ * @brief A small 2D polygon with a fixed capacity, stored on the stack (coordinates are stored as separate x and y
+ * arrays). It is meant for feet and support polygons, so that their computations never allocate.
+ *
+ * Unless stated otherwise, the methods expect a convex and clockwise polygon (see \ref convex_hull).
+ */
+class Polygon2d
+{
+public:
+  /**
+   * @brief Maximum number of points (the hull of two rectangular feet)
+   */
+  static constexpr int capacity = 8;
+
+  typedef Eigen::Matrix<double, capacity, 2> Normals;
+  typedef Eigen::Matrix<double, capacity, 1> Offsets;
+
+  Polygon2d();
+
+  /**
+   * @brief Builds a polygon from a list of points, throws if there are more than \ref capacity points
+   * @param points points
+   */
+  Polygon2d(const std::vector<Eigen::Vector2d>& points);
+
+  /**
+   * @brief Number of points
+   */
+  int size() const
+  {
+    return n;
+  }
+
+  /**
+   * @brief Removes all the points
+   */
+  void clear()
+  {
+    n = 0;
+  }
+
+  /**
+   * @brief Adds a point, throws if the polygon is full
+   * @param x x coordinate
+   * @param y y coordinate
+   */
+  void push_back(double x, double y);
+
+  /**
+   * @brief Returns the i-th point
+   * @param i index
+   */
+  Eigen::Vector2d point(int i) const
+  {
+    return Eigen::Vector2d(xs[i], ys[i]);
+  }
+
+  /**
+   * @brief Converts the polygon to a vector of points
+   */
+  std::vector<Eigen::Vector2d> to_vector() const;
+
+  /**
+   * @brief Computes the convex hull of the points (monotone chain). The hull is clockwise, without collinear points
+   * and starts with the lowest point along x.
+   */
+  Polygon2d convex_hull() const;
+
+  /**
+   * @brief Checks if a point is inside the polygon (boundary included), throws if the polygon is degenerate (see
+   * \ref half_planes)
+   * @param point point
+   * @param margin minimum distance from the point to the edges
+   */
+  bool contains(const Eigen::Vector2d& point, double margin = 0.) const;
+
+  /**
+   * @brief Checks if two convex polygons overlap using the separating axis theorem (touching polygons overlap)
+   * @param other other polygon
+   */
+  bool overlap(const Polygon2d& other) const;
+
+  /**
+   * @brief Computes the half-planes of the polygon, point p is inside if normals * p >= offsets. Only the
+   * \ref size first rows are set. Throws if the polygon has less than 3 points or duplicate consecutive points
+   * @param normals unit normals of the edges, pointing inside the polygon
+   * @param offsets offsets of the edges
+   */
+  void half_planes(Normals& normals, Offsets& offsets) const;
+
+protected:
+  Eigen::Array<double, capacity, 1> xs;
+  Eigen::Array<double, capacity, 1> ys;
+  int n;
+
+  // Checks if the projections of this polygon and other on the normals of the edges of this polygon are disjoint
+  bool separated_by_edges(const Polygon2d& other) const;
+};
+}  // namespace placo::tools